@@ -0,0 +1,20 @@
+# The app sources and defines shared by the host builds. Set ROOT to the
+# repository root before including.
+
+# Keep the version in step with the app
+APPVERSION_M := $(shell sed -n 's/^APPVERSION_M *= *//p' $(ROOT)/Makefile)
+APPVERSION_N := $(shell sed -n 's/^APPVERSION_N *= *//p' $(ROOT)/Makefile)
+APPVERSION_P := $(shell sed -n 's/^APPVERSION_P *= *//p' $(ROOT)/Makefile)
+
+DEFINES := TARGET_NANOS HOST_BUILD
+DEFINES += APPVERSION_M=$(APPVERSION_M) APPVERSION_N=$(APPVERSION_N) APPVERSION_P=$(APPVERSION_P)
+DEFINES += APPVERSION=\"$(APPVERSION_M).$(APPVERSION_N).$(APPVERSION_P)\"
+DEFINES += IO_SEPROXYHAL_BUFFER_SIZE_B=128
+DEFINES += PB_NO_ERRMSG=1
+DEFINES += PRINTF_DISABLE_SUPPORT_FLOAT PRINTF_DISABLE_SUPPORT_EXPONENTIAL PRINTF_DISABLE_SUPPORT_PTRDIFF_T
+DEFINES += PRINTF_NTOA_BUFFER_SIZE=9U PRINTF_FTOA_BUFFER_SIZE=0
+
+APP_INCLUDES := $(ROOT)/host/include $(ROOT)/host $(ROOT)/src $(ROOT)/proto $(ROOT) $(ROOT)/vendor/nanopb
+
+APP_SOURCES := $(wildcard $(ROOT)/src/*.c) $(wildcard $(ROOT)/proto/*.pb.c)
+APP_SOURCES += $(addprefix $(ROOT)/vendor/nanopb/, pb_common.c pb_decode.c pb_encode.c)
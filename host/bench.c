@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "debug.h"
+#include "histogram.h"
+#include "host.h"
+#include "session.h"
+
+// Replays recorded sessions through app_main and reports the latency of
+// each command, from the APDU reaching io_exchange to its response going
+// out, including the scripted button presses of a prompt.
+//
+//     hedera_bench [-n rounds] sessions/*.apdus
+//     hedera_bench -s commands [-w windows] [-d drift%] sessions/*.apdus
+//
+// The soak (-s) replays the sessions round-robin for the given number of
+// commands and fails if a response differs from the first round, if the
+// stack canary changes, or if the median latency of the last window is
+// more than drift% above that of the first.
+
+#define MAX_SESSIONS 32
+#define MAX_GROUPS 64
+
+// Commands are grouped by session and INS
+struct group_t {
+    char name[80];
+    struct histogram_t latency;
+};
+
+// The response each step gave in the first round, for the soak
+struct expected_t {
+    uint8_t apdu[SESSION_APDU_SIZE];
+    size_t length;
+};
+
+struct bench_t {
+    struct session_t sessions[MAX_SESSIONS];
+    size_t session_count;
+
+    struct group_t groups[MAX_GROUPS];
+    size_t group_count;
+    size_t* step_groups[MAX_SESSIONS];
+    struct expected_t* expected[MAX_SESSIONS];
+
+    uint64_t commands;   // Commands to run
+    uint64_t sent;       // Commands handed to the app so far
+    uint64_t completed;  // Responses received so far
+    size_t session;      // Session and step of the command in flight
+    size_t step;
+    size_t button_next;
+
+    uint64_t started;
+    uint64_t last_tick;
+    bool failed;
+
+    // Soak windows
+    bool soak;
+    uint64_t window_size;
+    struct histogram_t window;
+    uint64_t* window_p50;
+    size_t window_count;
+};
+
+static uint64_t now_ns() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t find_group(struct bench_t* bench, const char* session, uint8_t ins) {
+    char name[sizeof(bench->groups[0].name)];
+
+    snprintf(name, sizeof(name), "%s %02x", session, ins);
+
+    for (size_t i = 0; i < bench->group_count; i++) {
+        if (strcmp(bench->groups[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    if (bench->group_count == MAX_GROUPS) {
+        fprintf(stderr, "too many commands\n");
+        exit(2);
+    }
+
+    strcpy(bench->groups[bench->group_count].name, name);
+
+    return bench->group_count++;
+}
+
+static size_t next_apdu(void* user, uint8_t* apdu, size_t size) {
+    struct bench_t* bench = user;
+    const struct session_step_t* step;
+    uint64_t now = now_ns();
+
+    // The device ticks every 100 ms; keep the app's tick count in step
+    while (now - bench->last_tick >= 100000000ULL) {
+        bench->last_tick += 100000000ULL;
+        host_tick();
+    }
+
+    if (bench->sent == bench->commands || bench->failed) {
+        return 0;
+    }
+
+    step = &bench->sessions[bench->session].steps[bench->step];
+    if (step->length > size) {
+        return 0;
+    }
+
+    memmove(apdu, step->apdu, step->length);
+    bench->button_next = 0;
+    bench->sent++;
+
+    bench->started = now_ns();
+
+    return step->length;
+}
+
+static void advance(struct bench_t* bench) {
+    if (++bench->step == bench->sessions[bench->session].count) {
+        bench->step = 0;
+        bench->session = (bench->session + 1) % bench->session_count;
+    }
+}
+
+static void end_window(struct bench_t* bench) {
+    bench->window_p50[bench->window_count++] = histogram_percentile(&bench->window, 50);
+    memset(&bench->window, 0, sizeof(bench->window));
+}
+
+static void response(void* user, const uint8_t* apdu, size_t length) {
+    struct bench_t* bench = user;
+    uint64_t latency = now_ns() - bench->started;
+    struct expected_t* expected;
+    const struct session_t* session = &bench->sessions[bench->session];
+
+    histogram_add(
+        &bench->groups[bench->step_groups[bench->session][bench->step]].latency,
+        latency
+    );
+
+    expected = &bench->expected[bench->session][bench->step];
+    if (expected->length == 0) {
+        memmove(expected->apdu, apdu, length);
+        expected->length = length;
+    } else if (expected->length != length || memcmp(expected->apdu, apdu, length) != 0) {
+        fprintf(
+            stderr,
+            "%s: command %zu: response changed after %llu commands\n",
+            session->name,
+            bench->step + 1,
+            (unsigned long long) bench->completed
+        );
+        bench->failed = true;
+    }
+
+    if (debug_get_stack_canary() != 0xDEADBEEF) {
+        fprintf(stderr, "stack canary overwritten after %llu commands\n",
+                (unsigned long long) bench->completed);
+        bench->failed = true;
+    }
+
+    bench->completed++;
+
+    if (bench->soak) {
+        histogram_add(&bench->window, latency);
+        if (bench->completed % bench->window_size == 0) {
+            end_window(bench);
+        }
+    }
+
+    advance(bench);
+}
+
+static unsigned int next_button(void* user) {
+    struct bench_t* bench = user;
+    const struct session_step_t* step = &bench->sessions[bench->session].steps[bench->step];
+
+    if (bench->button_next == step->button_count) {
+        fprintf(
+            stderr,
+            "%s: command %zu: out of buttons on [%s]\n",
+            bench->sessions[bench->session].name,
+            bench->step + 1,
+            host_screen()
+        );
+        bench->failed = true;
+        return 0;
+    }
+
+    return session_button_mask(step->buttons[bench->button_next++]);
+}
+
+static void usage() {
+    fprintf(
+        stderr,
+        "usage: hedera_bench [-n rounds] [-s commands] [-w windows] [-d drift%%] session...\n"
+    );
+    exit(2);
+}
+
+int main(int argc, char* argv[]) {
+    static struct bench_t bench;
+    struct host_io_t io = {
+        .next_apdu = next_apdu,
+        .response = response,
+        .next_button = next_button,
+        .user = &bench,
+    };
+    uint64_t rounds = 1000;
+    uint64_t windows = 10;
+    double drift = 50;
+    uint64_t session_commands = 0;
+    uint64_t elapsed;
+    int arg;
+
+    for (arg = 1; arg < argc && argv[arg][0] == '-'; arg += 2) {
+        if (arg + 1 == argc) {
+            usage();
+        }
+
+        switch (argv[arg][1]) {
+            case 'n':
+                rounds = strtoull(argv[arg + 1], NULL, 10);
+                break;
+
+            case 's':
+                bench.soak = true;
+                bench.commands = strtoull(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'w':
+                windows = strtoull(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'd':
+                drift = strtod(argv[arg + 1], NULL);
+                break;
+
+            default:
+                usage();
+        }
+    }
+
+    if (arg == argc || argc - arg > MAX_SESSIONS || windows == 0) {
+        usage();
+    }
+
+    for (; arg < argc; arg++) {
+        struct session_t* session = &bench.sessions[bench.session_count];
+
+        if (!session_load(session, argv[arg])) {
+            return 2;
+        }
+        if (session->count == 0) {
+            continue;
+        }
+
+        bench.step_groups[bench.session_count] = calloc(session->count, sizeof(size_t));
+        bench.expected[bench.session_count] = calloc(session->count, sizeof(struct expected_t));
+
+        for (size_t i = 0; i < session->count; i++) {
+            bench.step_groups[bench.session_count][i] =
+                find_group(&bench, session->name, session->steps[i].apdu[1]);
+        }
+
+        session_commands += session->count;
+        bench.session_count++;
+    }
+
+    if (bench.session_count == 0) {
+        usage();
+    }
+
+    if (!bench.soak) {
+        bench.commands = rounds * session_commands;
+    }
+
+    if (bench.soak) {
+        bench.window_size = bench.commands / windows ? bench.commands / windows : 1;
+        bench.window_p50 = calloc(bench.commands / bench.window_size + 1, sizeof(uint64_t));
+    }
+
+    bench.last_tick = now_ns();
+    elapsed = now_ns();
+    host_run(&io);
+    elapsed = now_ns() - elapsed;
+
+    if (bench.completed < bench.commands && !bench.failed) {
+        fprintf(stderr, "session ended after %llu of %llu commands\n",
+                (unsigned long long) bench.completed,
+                (unsigned long long) bench.commands);
+        bench.failed = true;
+    }
+
+    printf("%-32s %10s %10s %10s %10s %10s\n", "command (us)", "count", "p50", "p90", "p99", "max");
+
+    for (size_t i = 0; i < bench.group_count; i++) {
+        const struct histogram_t* latency = &bench.groups[i].latency;
+
+        printf(
+            "%-32s %10llu %10.1f %10.1f %10.1f %10.1f\n",
+            bench.groups[i].name,
+            (unsigned long long) latency->total,
+            histogram_percentile(latency, 50) / 1000.0,
+            histogram_percentile(latency, 90) / 1000.0,
+            histogram_percentile(latency, 99) / 1000.0,
+            latency->max / 1000.0
+        );
+    }
+
+    printf(
+        "\n%llu commands in %.3f s, %.0f commands/s\n",
+        (unsigned long long) bench.completed,
+        elapsed / 1e9,
+        bench.completed / (elapsed / 1e9)
+    );
+
+    if (bench.soak && bench.window_count > 1) {
+        double change;
+
+        printf("\np50 (us) per window of %llu commands:", (unsigned long long) bench.window_size);
+        for (size_t i = 0; i < bench.window_count; i++) {
+            printf(" %.1f", bench.window_p50[i] / 1000.0);
+        }
+
+        change = 100.0 * ((double) bench.window_p50[bench.window_count - 1] / bench.window_p50[0] - 1);
+        printf("\nlatency drift %+.1f%% (limit %.1f%%)\n", change, drift);
+
+        if (change > drift) {
+            bench.failed = true;
+        }
+    }
+
+    return bench.failed ? 1 : 0;
+}
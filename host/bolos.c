@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include <ux.h>
+
+#include "debug.h"
+#include "ui.h"
+#include "host.h"
+
+// The BOLOS services the app calls, reduced to what runs in one process:
+// io_exchange hands APDUs to and from the driver in host.h, screens are
+// rendered to text, and button presses go straight to the handler of the
+// screen on display.
+
+static const struct host_io_t* host_io;
+
+// Whether the command last received has had its response
+static bool replied = true;
+
+// Exceptions
+
+static try_context_t* current_try_context;
+
+try_context_t* try_context_get(void) {
+    return current_try_context;
+}
+
+try_context_t* try_context_set(try_context_t* context) {
+    try_context_t* previous = current_try_context;
+    current_try_context = context;
+    return previous;
+}
+
+void os_longjmp(unsigned int exception) {
+    if (current_try_context == NULL) {
+        fprintf(stderr, "uncaught exception 0x%x\n", exception);
+        abort();
+    }
+
+    longjmp(current_try_context->jmp_buf, exception);
+}
+
+// Memory the linker script provides on the device
+
+unsigned long app_stack_canary;
+
+unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+unsigned int G_io_apdu_media = IO_APDU_MEDIA_USB_HID;
+
+const bagl_icon_details_t C_icon_back;
+const bagl_icon_details_t C_icon_dashboard;
+const bagl_icon_details_t C_icon_dashboard_x;
+const bagl_icon_details_t C_icon_crossmark;
+const bagl_icon_details_t C_icon_validate_14;
+
+// Screen
+
+#define SCREEN_ELEMENTS 16
+#define SCREEN_TEXT_SIZE 64
+
+static char screen_text[SCREEN_ELEMENTS][SCREEN_TEXT_SIZE];
+static unsigned int screen_element;
+
+void host_ux_display(
+    const bagl_element_t* elements,
+    unsigned int count,
+    bagl_element_callback_t preprocessor,
+    button_push_callback_t button
+) {
+    ux.elements = elements;
+    ux.elements_count = count;
+    ux.elements_preprocessor = preprocessor;
+    ux.button_push_handler = button;
+    ux.menu_entries = NULL;
+
+    host_ux_redisplay(0);
+}
+
+// As on the device, elements from index to the end are sent again
+void host_ux_redisplay(unsigned int index) {
+    for (unsigned int i = index; i < ux.elements_count && i < SCREEN_ELEMENTS; i++) {
+        const bagl_element_t* element = &ux.elements[i];
+
+        screen_text[i][0] = '\0';
+        screen_element = i;
+
+        if (ux.elements_preprocessor) {
+            element = ux.elements_preprocessor(element);
+        }
+        if (element) {
+            io_seproxyhal_display(element);
+        }
+    }
+
+    for (unsigned int i = ux.elements_count; i < SCREEN_ELEMENTS; i++) {
+        screen_text[i][0] = '\0';
+    }
+}
+
+void host_ux_menu_display(const ux_menu_entry_t* menu) {
+    memset(screen_text, 0, sizeof(screen_text));
+    memset(&ux, 0, sizeof(ux));
+    ux.menu_entries = menu;
+
+    if (menu[0].line1) {
+        strncpy(screen_text[0], menu[0].line1, SCREEN_TEXT_SIZE - 1);
+    }
+    if (menu[0].line2) {
+        strncpy(screen_text[1], menu[0].line2, SCREEN_TEXT_SIZE - 1);
+    }
+}
+
+void io_seproxyhal_display_default(bagl_element_t* element) {
+    if (element->component.type == BAGL_LABELINE && element->text) {
+        strncpy(screen_text[screen_element], element->text, SCREEN_TEXT_SIZE - 1);
+    }
+}
+
+const char* host_screen() {
+    static char text[SCREEN_ELEMENTS * (SCREEN_TEXT_SIZE + 3)];
+    size_t length = 0;
+
+    text[0] = '\0';
+
+    for (unsigned int i = 0; i < SCREEN_ELEMENTS; i++) {
+        if (screen_text[i][0] == '\0') {
+            continue;
+        }
+
+        length += snprintf(
+            text + length,
+            sizeof(text) - length,
+            "%s%s",
+            length ? " | " : "",
+            screen_text[i]
+        );
+    }
+
+    return text;
+}
+
+// Fast events a simulated hold lasts for
+#define HOLD_FAST_EVENTS 12
+
+// Delivers one button event to the screen on display, if it takes any;
+// each event may move to another screen
+static void push_button(unsigned int mask, unsigned int counter) {
+    if (ux.button_push_handler) {
+        ux.button_push_handler(mask, counter);
+    }
+}
+
+// Buttons go down and come back up, like a quick press on the device. With
+// BUTTON_EVT_FAST in mask, the buttons are held instead, with the events of
+// io_seproxyhal_button_push: the first press, a repeat every 100 ms with
+// every BUTTON_FAST_ACTION_CS-th flagged fast once past
+// BUTTON_FAST_THRESHOLD_CS, and a release that has lost its
+// BUTTON_EVT_RELEASED flag.
+static void press_button(unsigned int mask) {
+    unsigned int buttons = mask & ~BUTTON_EVT_FAST;
+    unsigned int counter = 0;
+    unsigned int fast_events = 0;
+
+    push_button(buttons, counter);
+
+    if (!(mask & BUTTON_EVT_FAST)) {
+        push_button(BUTTON_EVT_RELEASED | buttons, counter);
+        return;
+    }
+
+    while (fast_events < HOLD_FAST_EVENTS) {
+        counter++;
+
+        if (counter >= BUTTON_FAST_THRESHOLD_CS && counter % BUTTON_FAST_ACTION_CS == 0) {
+            push_button(BUTTON_EVT_FAST | buttons, counter);
+            fast_events++;
+        } else {
+            push_button(buttons, counter);
+        }
+    }
+
+    push_button(buttons, counter);
+}
+
+void host_tick() {
+    G_io_seproxyhal_spi_buffer[0] = SEPROXYHAL_TAG_TICKER_EVENT;
+    G_io_seproxyhal_spi_buffer[1] = 0;
+    G_io_seproxyhal_spi_buffer[2] = 0;
+
+    io_event(CHANNEL_SPI);
+}
+
+// APDU exchange
+
+unsigned short io_exchange(unsigned char channel, unsigned short tx_len) {
+    size_t rx;
+
+    if (tx_len > 0) {
+        host_io->response(host_io->user, G_io_apdu_buffer, tx_len);
+        replied = true;
+
+        if (channel & IO_RETURN_AFTER_TX) {
+            return 0;
+        }
+    }
+
+    // The handler may have returned before replying: run the UI until it
+    // does
+    if (channel & IO_ASYNCH_REPLY) {
+        while (!replied) {
+            unsigned int mask = host_io->next_button
+                ? host_io->next_button(host_io->user)
+                : 0;
+
+            if (mask == 0) {
+                THROW(EXCEPTION_IO_RESET);
+            }
+
+            press_button(mask);
+        }
+    }
+
+    rx = host_io->next_apdu(host_io->user, G_io_apdu_buffer, sizeof(G_io_apdu_buffer));
+    if (rx == 0) {
+        THROW(EXCEPTION_IO_RESET);
+    }
+
+    replied = false;
+
+    return rx;
+}
+
+void host_run(const struct host_io_t* io) {
+    host_io = io;
+    replied = true;
+
+    debug_init_stack_canary();
+
+    BEGIN_TRY {
+        TRY {
+            UX_INIT();
+            io_seproxyhal_init();
+            ui_idle();
+            app_main();
+        }
+        CATCH(EXCEPTION_IO_RESET) {
+            // the driver ended the session
+        }
+        FINALLY {
+            // explicitly do nothing
+        }
+    }
+    END_TRY;
+
+    host_io = NULL;
+}
+
+// SEPROXYHAL, which has nothing to talk to on the host
+
+void io_seproxyhal_init(void) {
+}
+
+void io_seproxyhal_general_status(void) {
+}
+
+unsigned int io_seproxyhal_spi_is_status_sent(void) {
+    return 1;
+}
+
+void io_seproxyhal_spi_send(const unsigned char* buffer, unsigned short length) {
+    UNUSED(buffer);
+    UNUSED(length);
+}
+
+unsigned short io_seproxyhal_spi_recv(unsigned char* buffer, unsigned short maxlength, unsigned int flags) {
+    UNUSED(buffer);
+    UNUSED(maxlength);
+    UNUSED(flags);
+    return 0;
+}
+
+void USB_power(unsigned char enabled) {
+    UNUSED(enabled);
+}
+
+// OS
+
+void os_boot(void) {
+    current_try_context = NULL;
+}
+
+void os_sched_exit(unsigned int exit_code) {
+    exit(exit_code & 0xFF);
+}
+
+void reset(void) {
+    THROW(EXCEPTION_IO_RESET);
+}
+
+unsigned int os_global_pin_is_validated(void) {
+    return 1;
+}
+
+unsigned int os_setting_get(unsigned int setting_id, unsigned char* value, unsigned int maxlen) {
+    UNUSED(setting_id);
+    UNUSED(value);
+    UNUSED(maxlen);
+    return 0;
+}
@@ -0,0 +1,643 @@
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "farm.h"
+#include "globals.h"
+#include "handlers.h"
+
+static const uint8_t UNAVAILABLE[2] = {
+    HEDERA_FARM_SW_UNAVAILABLE >> 8,
+    HEDERA_FARM_SW_UNAVAILABLE & 0xFF,
+};
+
+void hedera_farm_init(struct hedera_farm_t* farm) {
+    memset(farm, 0, sizeof(*farm));
+
+    farm->queue_limit = 32;
+    farm->review_limit = 1;
+    farm->health_interval_ms = 1000;
+
+    pthread_mutex_init(&farm->lock, NULL);
+    pthread_cond_init(&farm->work, NULL);
+    pthread_cond_init(&farm->room, NULL);
+    pthread_cond_init(&farm->done, NULL);
+}
+
+bool hedera_farm_add(
+    struct hedera_farm_t* farm,
+    const char* address,
+    uint32_t first,
+    uint32_t last
+) {
+    struct hedera_farm_device_t* device;
+
+    if (farm->device_count == HEDERA_FARM_MAX_DEVICES ||
+        strlen(address) >= sizeof(device->address)) {
+        return false;
+    }
+
+    device = &farm->devices[farm->device_count++];
+    strcpy(device->address, address);
+    device->first = first;
+    device->last = last;
+    device->farm = farm;
+
+    return true;
+}
+
+void hedera_farm_job_init(
+    struct hedera_farm_job_t* job,
+    const uint8_t* apdu,
+    size_t length
+) {
+    const uint8_t* data = apdu + OFFSET_CDATA;
+    uint8_t ins;
+
+    memset(job, 0, sizeof(*job));
+
+    if (length > HEDERA_APDU_SIZE) {
+        length = HEDERA_APDU_SIZE;
+    }
+
+    memmove(job->apdu, apdu, length);
+    job->length = length;
+    job->index = HEDERA_FARM_ANY_INDEX;
+    job->device = -1;
+
+    if (length < OFFSET_CDATA + 4 || apdu[OFFSET_CLA] != CLA) {
+        return;
+    }
+
+    // Both commands lead with the key index; GET_PUBLIC_KEY prompts
+    // unless P1 is set
+    ins = apdu[OFFSET_INS];
+    if (ins == INS_GET_PUBLIC_KEY || ins == INS_SIGN_TRANSACTION) {
+        job->index = (uint32_t) data[0] | data[1] << 8 | data[2] << 16 | (uint32_t) data[3] << 24;
+        job->review = ins == INS_SIGN_TRANSACTION || apdu[OFFSET_P1] == 0;
+    }
+}
+
+static bool holds(const struct hedera_farm_device_t* device, int64_t index) {
+    return index == HEDERA_FARM_ANY_INDEX || (index >= device->first && index <= device->last);
+}
+
+static bool is_full(const struct hedera_farm_t* farm, const struct hedera_farm_device_t* device) {
+    return device->queued >= (device->reviewing ? farm->review_limit : farm->queue_limit);
+}
+
+// Jobs ahead of a new one, counting a review as a full queue
+static size_t load_of(const struct hedera_farm_t* farm, const struct hedera_farm_device_t* device) {
+    return device->queued + device->running + (device->reviewing ? farm->queue_limit : 0);
+}
+
+#define ROUTE_NONE (-1)  // no healthy device holds the index
+#define ROUTE_FULL (-2)  // all that do are full
+
+// The least loaded healthy device holding the job's index, other than
+// exclude; limits are ignored unless limited
+static int route(
+    const struct hedera_farm_t* farm,
+    const struct hedera_farm_job_t* job,
+    const struct hedera_farm_device_t* exclude,
+    bool limited
+) {
+    int best = ROUTE_NONE;
+    size_t best_load = 0;
+
+    for (size_t i = 0; i < farm->device_count; i++) {
+        const struct hedera_farm_device_t* device = &farm->devices[i];
+        size_t load;
+
+        if (device == exclude || !device->healthy || !holds(device, job->index)) {
+            continue;
+        }
+
+        if (limited && is_full(farm, device)) {
+            if (best == ROUTE_NONE) {
+                best = ROUTE_FULL;
+            }
+            continue;
+        }
+
+        load = load_of(farm, device);
+        if (best < 0 || load < best_load) {
+            best = i;
+            best_load = load;
+        }
+    }
+
+    return best;
+}
+
+static void push(struct hedera_farm_device_t* device, struct hedera_farm_job_t* job) {
+    job->next = NULL;
+
+    if (device->tail) {
+        device->tail->next = job;
+    } else {
+        device->head = job;
+    }
+
+    device->tail = job;
+    device->queued++;
+}
+
+// Unlinks job, found after previous (NULL for the head)
+static void unlink_job(
+    struct hedera_farm_device_t* device,
+    struct hedera_farm_job_t* previous,
+    struct hedera_farm_job_t* job
+) {
+    if (previous) {
+        previous->next = job->next;
+    } else {
+        device->head = job->next;
+    }
+
+    if (device->tail == job) {
+        device->tail = previous;
+    }
+
+    job->next = NULL;
+    device->queued--;
+}
+
+// Hands a job its response: the callback first, then waiters. Called
+// without the lock.
+static void finish(
+    struct hedera_farm_t* farm,
+    struct hedera_farm_job_t* job,
+    const uint8_t* response,
+    size_t length
+) {
+    if (response != job->response) {
+        memmove(job->response, response, length);
+        job->response_length = length;
+    }
+
+    if (job->done_callback) {
+        job->done_callback(job->user, job);
+    }
+
+    pthread_mutex_lock(&farm->lock);
+    job->done = true;
+    pthread_cond_broadcast(&farm->done);
+    pthread_mutex_unlock(&farm->lock);
+}
+
+// Finishes a list of jobs linked through next with UNAVAILABLE. Called
+// without the lock.
+static void fail_all(struct hedera_farm_t* farm, struct hedera_farm_job_t* job) {
+    while (job) {
+        struct hedera_farm_job_t* next = job->next;
+
+        finish(farm, job, UNAVAILABLE, sizeof(UNAVAILABLE));
+        job = next;
+    }
+}
+
+static bool submit(struct hedera_farm_t* farm, struct hedera_farm_job_t* job, bool wait) {
+    int target;
+
+    pthread_mutex_lock(&farm->lock);
+
+    job->done = false;
+    job->response_length = 0;
+    job->device = -1;
+
+    for (;;) {
+        target = farm->stopping ? ROUTE_NONE : route(farm, job, NULL, true);
+
+        if (target != ROUTE_FULL || !wait) {
+            break;
+        }
+
+        pthread_cond_wait(&farm->room, &farm->lock);
+    }
+
+    if (target >= 0) {
+        push(&farm->devices[target], job);
+        pthread_cond_broadcast(&farm->work);
+    }
+
+    pthread_mutex_unlock(&farm->lock);
+
+    if (target == ROUTE_NONE) {
+        finish(farm, job, UNAVAILABLE, sizeof(UNAVAILABLE));
+    }
+
+    return target != ROUTE_FULL;
+}
+
+void hedera_farm_submit(struct hedera_farm_t* farm, struct hedera_farm_job_t* job) {
+    submit(farm, job, true);
+}
+
+bool hedera_farm_try_submit(struct hedera_farm_t* farm, struct hedera_farm_job_t* job) {
+    return submit(farm, job, false);
+}
+
+void hedera_farm_wait(struct hedera_farm_t* farm, struct hedera_farm_job_t* job) {
+    pthread_mutex_lock(&farm->lock);
+
+    while (!job->done) {
+        pthread_cond_wait(&farm->done, &farm->lock);
+    }
+
+    pthread_mutex_unlock(&farm->lock);
+}
+
+// Takes the device's next jobs into batch: a review alone, or a run of
+// other jobs up to the transport's depth. With nothing queued, steals
+// jobs other than reviews from the device with the most it could take.
+static size_t take(
+    struct hedera_farm_t* farm,
+    struct hedera_farm_device_t* device,
+    struct hedera_farm_job_t** batch
+) {
+    size_t depth = device->transport.depth ? device->transport.depth : 1;
+    struct hedera_farm_device_t* victim = NULL;
+    struct hedera_farm_job_t* previous = NULL;
+    struct hedera_farm_job_t* job;
+    size_t most = 0;
+    size_t count = 0;
+
+    if (device->head) {
+        if (device->head->review) {
+            batch[count++] = device->head;
+            unlink_job(device, NULL, device->head);
+            device->reviews++;
+
+            return count;
+        }
+
+        while (count < depth && device->head && !device->head->review) {
+            batch[count++] = device->head;
+            unlink_job(device, NULL, device->head);
+        }
+
+        return count;
+    }
+
+    for (size_t i = 0; i < farm->device_count; i++) {
+        struct hedera_farm_device_t* other = &farm->devices[i];
+        size_t stealable = 0;
+
+        if (other == device) {
+            continue;
+        }
+
+        for (job = other->head; job; job = job->next) {
+            stealable += !job->review && holds(device, job->index);
+        }
+
+        if (stealable > most) {
+            victim = other;
+            most = stealable;
+        }
+    }
+
+    if (!victim) {
+        return 0;
+    }
+
+    job = victim->head;
+    while (job && count < depth) {
+        struct hedera_farm_job_t* next = job->next;
+
+        if (!job->review && holds(device, job->index)) {
+            batch[count++] = job;
+            unlink_job(victim, previous, job);
+        } else {
+            previous = job;
+        }
+
+        job = next;
+    }
+
+    device->stolen += count;
+
+    return count;
+}
+
+// Copies a response into its job; jobs without one keep a length of 0
+static void on_response(void* user, uint16_t status, const uint8_t* data, size_t length) {
+    struct hedera_farm_job_t* job = user;
+
+    if (status < 0x100) {
+        return;
+    }
+
+    memmove(job->response, data, length);
+    job->response[length] = status >> 8;
+    job->response[length + 1] = status & 0xFF;
+    job->response_length = length + 2;
+}
+
+// Sends a batch and collects its responses; false if the device failed
+static bool run(struct hedera_farm_device_t* device, struct hedera_farm_job_t** batch, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        batch[i]->response_length = 0;
+        hedera_submit_apdu(&device->client, batch[i]->apdu, batch[i]->length, on_response, batch[i]);
+    }
+
+    return hedera_flush(&device->client) == count;
+}
+
+// Connects if need be and asks the device for its configuration
+static bool check(
+    struct hedera_farm_device_t* device,
+    /* out */ struct hedera_configuration_t* configuration
+) {
+    if (!device->connected) {
+        if (!hedera_socket_open(&device->transport, device->address)) {
+            return false;
+        }
+
+        hedera_client_init(&device->client, &device->transport);
+        device->connected = true;
+    }
+
+    return hedera_get_configuration(&device->client, configuration) == HEDERA_SW_OK;
+}
+
+// Counts a health check, called with the lock
+static void checked(
+    struct hedera_farm_device_t* device,
+    bool ok,
+    const struct hedera_configuration_t* configuration
+) {
+    device->health_checks++;
+
+    if (ok) {
+        device->configuration = *configuration;
+    }
+}
+
+static void disconnect(struct hedera_farm_device_t* device) {
+    if (device->connected) {
+        device->transport.close(device->transport.user);
+        device->connected = false;
+    }
+}
+
+// Marks a device that failed unhealthy and moves its work elsewhere: jobs
+// other than reviews left unanswered in the batch (NULL for the answered
+// ones), and its whole queue. Returns
+// the jobs with nowhere to go, linked through next. Called with the lock.
+static struct hedera_farm_job_t* evacuate(
+    struct hedera_farm_t* farm,
+    struct hedera_farm_device_t* device,
+    struct hedera_farm_job_t** batch,
+    size_t count
+) {
+    struct hedera_farm_job_t* failed = NULL;
+    struct hedera_farm_job_t* job;
+
+    device->healthy = false;
+    device->failures++;
+
+    // Unanswered batch jobs go in front of the queue, oldest first
+    for (size_t i = count; i > 0; i--) {
+        job = batch[i - 1];
+
+        if (!job) {
+            continue;
+        }
+
+        if (job->review) {
+            // The user may have seen it already; let the caller decide
+            job->next = failed;
+            failed = job;
+        } else {
+            job->next = device->head;
+            device->head = job;
+            if (!device->tail) {
+                device->tail = job;
+            }
+            device->queued++;
+        }
+    }
+
+    while ((job = device->head) != NULL) {
+        int target = route(farm, job, device, false);
+
+        unlink_job(device, NULL, job);
+
+        if (target >= 0) {
+            push(&farm->devices[target], job);
+        } else {
+            job->next = failed;
+            failed = job;
+        }
+    }
+
+    pthread_cond_broadcast(&farm->work);
+    pthread_cond_broadcast(&farm->room);
+
+    return failed;
+}
+
+static void deadline_after(struct timespec* deadline, unsigned int ms) {
+    clock_gettime(CLOCK_REALTIME, deadline);
+
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (long) (ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+static bool has_passed(const struct timespec* deadline) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return now.tv_sec > deadline->tv_sec ||
+        (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+static void* device_main(void* user) {
+    struct hedera_farm_device_t* device = user;
+    struct hedera_farm_t* farm = device->farm;
+    struct hedera_farm_job_t* batch[HEDERA_QUEUE_SIZE];
+    struct hedera_configuration_t configuration;
+    struct timespec idle_until;
+
+    pthread_mutex_lock(&farm->lock);
+    deadline_after(&idle_until, 0);
+
+    while (!farm->stopping) {
+        struct hedera_farm_job_t* failed = NULL;
+        size_t count;
+        bool ok;
+
+        if (!device->healthy) {
+            if (!has_passed(&idle_until)) {
+                pthread_cond_timedwait(&farm->work, &farm->lock, &idle_until);
+                continue;
+            }
+
+            pthread_mutex_unlock(&farm->lock);
+            disconnect(device);
+            ok = check(device, &configuration);
+            pthread_mutex_lock(&farm->lock);
+            checked(device, ok, &configuration);
+            device->healthy = ok;
+
+            // Wakes submitters, and hedera_farm_start on the first check
+            pthread_cond_broadcast(&farm->room);
+
+            deadline_after(&idle_until, farm->health_interval_ms);
+            continue;
+        }
+
+        count = take(farm, device, batch);
+
+        if (count == 0) {
+            if (pthread_cond_timedwait(&farm->work, &farm->lock, &idle_until) != ETIMEDOUT) {
+                continue;
+            }
+
+            // Idle for the interval: health check, holding off new work
+            device->running = 1;
+            pthread_mutex_unlock(&farm->lock);
+            ok = check(device, &configuration);
+            pthread_mutex_lock(&farm->lock);
+            checked(device, ok, &configuration);
+            device->running = 0;
+
+            if (!ok) {
+                failed = evacuate(farm, device, NULL, 0);
+            }
+
+            deadline_after(&idle_until, farm->health_interval_ms);
+        } else {
+            device->running = count;
+            device->reviewing = batch[0]->review;
+            pthread_mutex_unlock(&farm->lock);
+
+            ok = run(device, batch, count);
+
+            // Answered jobs are done whatever became of the rest, and may
+            // be freed once finished
+            for (size_t i = 0; i < count; i++) {
+                if (batch[i]->response_length > 0) {
+                    batch[i]->device = device - farm->devices;
+                    finish(farm, batch[i], batch[i]->response, batch[i]->response_length);
+                    batch[i] = NULL;
+                }
+            }
+
+            pthread_mutex_lock(&farm->lock);
+            device->running = 0;
+            device->reviewing = false;
+
+            if (ok) {
+                device->completed += count;
+            } else {
+                failed = evacuate(farm, device, batch, count);
+            }
+
+            pthread_cond_broadcast(&farm->room);
+            deadline_after(&idle_until, farm->health_interval_ms);
+        }
+
+        if (failed) {
+            pthread_mutex_unlock(&farm->lock);
+            fail_all(farm, failed);
+            pthread_mutex_lock(&farm->lock);
+        }
+    }
+
+    pthread_mutex_unlock(&farm->lock);
+    disconnect(device);
+
+    return NULL;
+}
+
+void hedera_farm_start(struct hedera_farm_t* farm) {
+    struct timespec deadline;
+    bool waiting = true;
+
+    // Devices start unhealthy, so each thread begins with a health check
+    for (size_t i = 0; i < farm->device_count; i++) {
+        pthread_create(&farm->devices[i].thread, NULL, device_main, &farm->devices[i]);
+    }
+
+    deadline_after(&deadline, farm->health_interval_ms);
+
+    pthread_mutex_lock(&farm->lock);
+
+    while (waiting) {
+        waiting = false;
+        for (size_t i = 0; i < farm->device_count; i++) {
+            waiting = waiting || farm->devices[i].health_checks == 0;
+        }
+
+        if (waiting && pthread_cond_timedwait(&farm->room, &farm->lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&farm->lock);
+}
+
+void hedera_farm_stop(struct hedera_farm_t* farm) {
+    struct hedera_farm_job_t* failed = NULL;
+
+    pthread_mutex_lock(&farm->lock);
+    farm->stopping = true;
+    pthread_cond_broadcast(&farm->work);
+    pthread_cond_broadcast(&farm->room);
+    pthread_mutex_unlock(&farm->lock);
+
+    for (size_t i = 0; i < farm->device_count; i++) {
+        pthread_join(farm->devices[i].thread, NULL);
+    }
+
+    for (size_t i = 0; i < farm->device_count; i++) {
+        struct hedera_farm_device_t* device = &farm->devices[i];
+        struct hedera_farm_job_t* job;
+
+        while ((job = device->head) != NULL) {
+            unlink_job(device, NULL, job);
+            job->next = failed;
+            failed = job;
+        }
+    }
+
+    fail_all(farm, failed);
+}
+
+void hedera_farm_report(struct hedera_farm_t* farm, FILE* out) {
+    pthread_mutex_lock(&farm->lock);
+
+    for (size_t i = 0; i < farm->device_count; i++) {
+        const struct hedera_farm_device_t* device = &farm->devices[i];
+
+        fprintf(
+            out,
+            "%-24s %-9s %u.%u.%u  keys %u-%u  queued %zu%s  completed %llu  reviews %llu"
+            "  stolen %llu  health checks %llu  failures %llu\n",
+            device->address,
+            device->healthy ? "healthy" : "unhealthy",
+            device->configuration.major,
+            device->configuration.minor,
+            device->configuration.patch,
+            device->first,
+            device->last,
+            device->queued,
+            device->reviewing ? " (reviewing)" : "",
+            (unsigned long long) device->completed,
+            (unsigned long long) device->reviews,
+            (unsigned long long) device->stolen,
+            (unsigned long long) device->health_checks,
+            (unsigned long long) device->failures
+        );
+    }
+
+    pthread_mutex_unlock(&farm->lock);
+}
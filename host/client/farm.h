@@ -0,0 +1,168 @@
+#ifndef LEDGER_HEDERA_FARM_H
+#define LEDGER_HEDERA_FARM_H 1
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hedera_client.h"
+
+// Scheduler for a pool of devices running the app, each reached through a
+// socket (hedera_client.h) and served by a thread of its own.
+//
+//     struct hedera_farm_t farm;
+//     struct hedera_farm_job_t job;
+//
+//     hedera_farm_init(&farm);
+//     hedera_farm_add(&farm, "/tmp/device-0.sock", 0, 99);
+//     hedera_farm_add(&farm, "/tmp/device-1.sock", 100, 199);
+//     hedera_farm_start(&farm);
+//
+//     hedera_farm_job_init(&job, apdu, length);
+//     hedera_farm_submit(&farm, &job);
+//     hedera_farm_wait(&farm, &job);
+//     ... job.response, job.response_length
+//
+// Each device has a queue. A job that names a key index goes to a healthy
+// device holding that index, the least loaded one; any other job goes to
+// any healthy device.
+//
+// A job the user must approve on the device (signing, a prompted public
+// key) is a review. A device works through a review alone and can take
+// only review_limit more jobs meanwhile: when every device a job may go to
+// is full, hedera_farm_submit waits for room.
+//
+// Other jobs, silent key lookups above all, are pipelined to the device
+// up to the transport's depth, and a device with nothing queued steals them
+// from the others, oldest first.
+//
+// A device left idle for health_interval_ms is asked for its configuration.
+// One that fails this, or any request, is unhealthy until it connects and
+// answers again: its queued jobs go to other devices, and a review it was
+// working on fails with HEDERA_FARM_SW_UNAVAILABLE.
+
+#define HEDERA_FARM_MAX_DEVICES 64
+
+// ISO 7816 "no precise diagnosis", which the app itself never returns:
+// no device could answer
+#define HEDERA_FARM_SW_UNAVAILABLE 0x6F00
+
+// Key index of a job that any device can answer
+#define HEDERA_FARM_ANY_INDEX (-1)
+
+struct hedera_farm_job_t;
+struct hedera_farm_t;
+
+// Called on the device's thread once a job is answered
+typedef void hedera_farm_done_t(void* user, struct hedera_farm_job_t* job);
+
+struct hedera_farm_job_t {
+    uint8_t apdu[HEDERA_APDU_SIZE];
+    size_t length;
+
+    // Key index the job is routed on, or HEDERA_FARM_ANY_INDEX
+    int64_t index;
+    bool review;
+
+    hedera_farm_done_t* done_callback;
+    void* user;
+
+    // Response, data then status word, and the device that gave it
+    uint8_t response[HEDERA_APDU_SIZE];
+    size_t response_length;
+    int device;
+    bool done;
+
+    struct hedera_farm_job_t* next;
+};
+
+struct hedera_farm_device_t {
+    char address[108];
+    uint32_t first;
+    uint32_t last;
+
+    struct hedera_transport_t transport;
+    struct hedera_client_t client;
+    bool connected;
+    bool healthy;
+    struct hedera_configuration_t configuration;
+
+    // Queued jobs, oldest first
+    struct hedera_farm_job_t* head;
+    struct hedera_farm_job_t* tail;
+    size_t queued;
+
+    // Jobs sent to the device and not yet answered
+    size_t running;
+    bool reviewing;
+
+    uint64_t completed;
+    uint64_t reviews;
+    uint64_t stolen;
+    uint64_t health_checks;
+    uint64_t failures;
+
+    struct hedera_farm_t* farm;
+    pthread_t thread;
+};
+
+struct hedera_farm_t {
+    struct hedera_farm_device_t devices[HEDERA_FARM_MAX_DEVICES];
+    size_t device_count;
+
+    // Most jobs a device may have queued; fewer while it is reviewing
+    size_t queue_limit;
+    size_t review_limit;
+    unsigned int health_interval_ms;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work;   // a job was queued, or the farm is stopping
+    pthread_cond_t room;   // a queue got shorter, or a device healthy
+    pthread_cond_t done;   // a job was answered
+    bool stopping;
+};
+
+// Defaults: 32 queued per device, 1 during a review, health every second
+extern void hedera_farm_init(struct hedera_farm_t* farm);
+
+// Adds a device holding key indexes first to last, before the farm is
+// started; false if the farm is full
+extern bool hedera_farm_add(
+    struct hedera_farm_t* farm,
+    const char* address,
+    uint32_t first,
+    uint32_t last
+);
+
+// Starts the devices' threads and waits up to the health interval for each
+// to connect and pass a health check. Devices that cannot be reached are
+// retried at the health interval.
+extern void hedera_farm_start(struct hedera_farm_t* farm);
+
+// Fails the queued jobs, waits for the devices' threads and disconnects
+extern void hedera_farm_stop(struct hedera_farm_t* farm);
+
+// Fills in a job for a request APDU, reading its key index and whether it
+// is a review from the command
+extern void hedera_farm_job_init(
+    struct hedera_farm_job_t* job,
+    const uint8_t* apdu,
+    size_t length
+);
+
+// Queues a job, waiting for room while every device it may go to is full.
+// A job no healthy device holds is answered at once with
+// HEDERA_FARM_SW_UNAVAILABLE.
+extern void hedera_farm_submit(struct hedera_farm_t* farm, struct hedera_farm_job_t* job);
+
+// As hedera_farm_submit, but false instead of waiting for room
+extern bool hedera_farm_try_submit(struct hedera_farm_t* farm, struct hedera_farm_job_t* job);
+
+// Waits for a submitted job to be answered
+extern void hedera_farm_wait(struct hedera_farm_t* farm, struct hedera_farm_job_t* job);
+
+// One line per device: health, version, queue and counters
+extern void hedera_farm_report(struct hedera_farm_t* farm, FILE* out);
+
+#endif // LEDGER_HEDERA_FARM_H
@@ -0,0 +1,224 @@
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hedera_client.h"
+
+// Command-line use of the client library, and a measure of what pipelining
+// buys on a given transport:
+//
+//     hedera_cli -a 127.0.0.1:9999 config
+//     hedera_cli -a /tmp/device.sock pubkey 3 silent
+//     hedera_cli -a /tmp/device.sock sign 0 body.bin
+//     hedera_cli -a /tmp/device.sock lookup 0 64
+
+static void usage(void) {
+    fprintf(
+        stderr,
+        "usage: hedera_cli -a host:port|path command\n"
+        "\n"
+        "    config                  app version\n"
+        "    pubkey INDEX [silent]   public key of a key index\n"
+        "    sign INDEX BODY         signature of a serialized TransactionBody\n"
+        "    lookup FIRST COUNT      silent lookups one at a time, then pipelined\n"
+    );
+    exit(2);
+}
+
+static void print_hex(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        printf("%02x", data[i]);
+    }
+    printf("\n");
+}
+
+static int report(uint16_t status) {
+    switch (status) {
+        case HEDERA_STATUS_TRANSPORT:
+            fprintf(stderr, "hedera_cli: transport failed\n");
+            break;
+        case HEDERA_STATUS_TOO_LARGE:
+            fprintf(stderr, "hedera_cli: body over %d bytes\n", HEDERA_MAX_BODY_SIZE);
+            break;
+        case HEDERA_STATUS_BAD_RESPONSE:
+            fprintf(stderr, "hedera_cli: short response\n");
+            break;
+        default:
+            fprintf(stderr, "hedera_cli: status %04x\n", status);
+            break;
+    }
+
+    return 1;
+}
+
+static double now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+struct lookup_t {
+    uint8_t key[HEDERA_PUBLIC_KEY_SIZE];
+    uint16_t status;
+};
+
+static void on_lookup(void* user, uint16_t status, const uint8_t* data, size_t length) {
+    struct lookup_t* lookup = user;
+
+    lookup->status = status;
+    if (status == HEDERA_SW_OK && length >= HEDERA_PUBLIC_KEY_SIZE) {
+        memmove(lookup->key, data, HEDERA_PUBLIC_KEY_SIZE);
+    } else if (status == HEDERA_SW_OK) {
+        lookup->status = HEDERA_STATUS_BAD_RESPONSE;
+    }
+}
+
+// Looks up count keys one round trip at a time, then again through the
+// queue, and checks both give the same keys
+static int lookup(struct hedera_client_t* client, uint32_t first, uint32_t count) {
+    struct lookup_t* sequential = calloc(count, sizeof(*sequential));
+    struct lookup_t* pipelined = calloc(count, sizeof(*pipelined));
+    double start, sequential_time, pipelined_time;
+    int result = 0;
+
+    start = now();
+    for (uint32_t i = 0; i < count; i++) {
+        sequential[i].status = hedera_get_public_key(client, first + i, true, sequential[i].key);
+    }
+    sequential_time = now() - start;
+
+    start = now();
+    for (uint32_t i = 0; i < count; i++) {
+        if (!hedera_submit_public_key(client, first + i, true, on_lookup, &pipelined[i])) {
+            hedera_flush(client);
+            hedera_submit_public_key(client, first + i, true, on_lookup, &pipelined[i]);
+        }
+    }
+    hedera_flush(client);
+    pipelined_time = now() - start;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (sequential[i].status != HEDERA_SW_OK) {
+            result = report(sequential[i].status);
+            break;
+        }
+        if (pipelined[i].status != HEDERA_SW_OK) {
+            result = report(pipelined[i].status);
+            break;
+        }
+        if (memcmp(sequential[i].key, pipelined[i].key, HEDERA_PUBLIC_KEY_SIZE) != 0) {
+            fprintf(stderr, "hedera_cli: keys of index %u differ\n", first + i);
+            result = 1;
+            break;
+        }
+    }
+
+    printf(
+        "sequential  %u lookups  %8.2f ms  %8.0f/s\n",
+        count, sequential_time * 1e3, count / sequential_time
+    );
+    printf(
+        "pipelined   %u lookups  %8.2f ms  %8.0f/s  depth %u\n",
+        count, pipelined_time * 1e3, count / pipelined_time, client->transport->depth
+    );
+
+    free(sequential);
+    free(pipelined);
+
+    return result;
+}
+
+static int sign(struct hedera_client_t* client, uint32_t index, const char* path) {
+    uint8_t body[HEDERA_MAX_BODY_SIZE + 1];
+    uint8_t signature[HEDERA_SIGNATURE_SIZE];
+    FILE* file = fopen(path, "rb");
+    size_t length;
+    uint16_t status;
+
+    if (!file) {
+        perror(path);
+        return 1;
+    }
+
+    length = fread(body, 1, sizeof(body), file);
+    fclose(file);
+
+    status = hedera_sign_transaction(client, index, body, length, signature);
+    if (status != HEDERA_SW_OK) {
+        return report(status);
+    }
+
+    print_hex(signature, sizeof(signature));
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    struct hedera_transport_t transport;
+    struct hedera_client_t client;
+    const char* address = NULL;
+    const char* command;
+    int result = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:")) != -1) {
+        switch (opt) {
+            case 'a':
+                address = optarg;
+                break;
+            default:
+                usage();
+        }
+    }
+
+    argc -= optind;
+    argv += optind;
+
+    if (!address || argc < 1) {
+        usage();
+    }
+
+    command = argv[0];
+
+    if (!hedera_socket_open(&transport, address)) {
+        fprintf(stderr, "hedera_cli: cannot connect to %s\n", address);
+        return 1;
+    }
+
+    hedera_client_init(&client, &transport);
+
+    if (strcmp(command, "config") == 0) {
+        struct hedera_configuration_t configuration;
+        uint16_t status = hedera_get_configuration(&client, &configuration);
+
+        if (status == HEDERA_SW_OK) {
+            printf("%u.%u.%u\n", configuration.major, configuration.minor, configuration.patch);
+        } else {
+            result = report(status);
+        }
+    } else if (strcmp(command, "pubkey") == 0 && argc >= 2) {
+        uint8_t key[HEDERA_PUBLIC_KEY_SIZE];
+        bool silent = argc >= 3 && strcmp(argv[2], "silent") == 0;
+        uint16_t status = hedera_get_public_key(&client, strtoul(argv[1], NULL, 0), silent, key);
+
+        if (status == HEDERA_SW_OK) {
+            print_hex(key, sizeof(key));
+        } else {
+            result = report(status);
+        }
+    } else if (strcmp(command, "sign") == 0 && argc == 3) {
+        result = sign(&client, strtoul(argv[1], NULL, 0), argv[2]);
+    } else if (strcmp(command, "lookup") == 0 && argc == 3) {
+        result = lookup(&client, strtoul(argv[1], NULL, 0), strtoul(argv[2], NULL, 0));
+    } else {
+        usage();
+    }
+
+    transport.close(transport.user);
+
+    return result;
+}
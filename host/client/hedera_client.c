@@ -0,0 +1,366 @@
+#include <string.h>
+
+#include "errors.h"
+#include "globals.h"
+#include "handlers.h"
+#include "hedera_client.h"
+
+// The framing follows src/main.c and the handlers: CLA INS P1 P2 Lc data,
+// answered by data and a status word
+
+_Static_assert(HEDERA_SW_OK == EXCEPTION_OK, "status words out of step with the app");
+_Static_assert(HEDERA_SW_USER_REJECTED == EXCEPTION_USER_REJECTED, "status words out of step with the app");
+_Static_assert(HEDERA_SW_MALFORMED_APDU == EXCEPTION_MALFORMED_APDU, "status words out of step with the app");
+_Static_assert(HEDERA_SW_UNKNOWN_INS == EXCEPTION_UNKNOWN_INS, "status words out of step with the app");
+
+// P1 of GET_PUBLIC_KEY that skips the prompt
+#define P1_SILENT 0x01
+
+void hedera_client_init(struct hedera_client_t* client, struct hedera_transport_t* transport) {
+    memset(client, 0, sizeof(*client));
+    client->transport = transport;
+}
+
+static size_t build_apdu(
+    uint8_t* apdu,
+    uint8_t ins,
+    uint8_t p1,
+    const uint8_t* data,
+    size_t length
+) {
+    apdu[OFFSET_CLA] = CLA;
+    apdu[OFFSET_INS] = ins;
+    apdu[OFFSET_P1] = p1;
+    apdu[OFFSET_P2] = 0;
+    apdu[OFFSET_LC] = length;
+    if (length > 0) {
+        memmove(apdu + OFFSET_CDATA, data, length);
+    }
+
+    return OFFSET_CDATA + length;
+}
+
+static void put_index(uint8_t* dst, uint32_t index) {
+    dst[0] = index;
+    dst[1] = index >> 8;
+    dst[2] = index >> 16;
+    dst[3] = index >> 24;
+}
+
+static size_t build_public_key(uint8_t* apdu, uint32_t index, bool silent) {
+    uint8_t data[4];
+
+    put_index(data, index);
+
+    return build_apdu(apdu, INS_GET_PUBLIC_KEY, silent ? P1_SILENT : 0, data, sizeof(data));
+}
+
+// 0 if the body does not fit one APDU
+static size_t build_sign(uint8_t* apdu, uint32_t index, const uint8_t* body, size_t length) {
+    uint8_t data[4 + HEDERA_MAX_BODY_SIZE];
+
+    if (length > HEDERA_MAX_BODY_SIZE) {
+        return 0;
+    }
+
+    put_index(data, index);
+    memmove(data + 4, body, length);
+
+    return build_apdu(apdu, INS_SIGN_TRANSACTION, 0, data, 4 + length);
+}
+
+static uint16_t status_of(const uint8_t* response, size_t length) {
+    return response[length - 2] << 8 | response[length - 1];
+}
+
+// Sends one request and waits for its response; returns the status and
+// copies expected bytes of data to out on success
+static uint16_t exchange(
+    struct hedera_client_t* client,
+    const uint8_t* apdu,
+    size_t length,
+    uint8_t* out,
+    size_t expected
+) {
+    struct hedera_transport_t* transport = client->transport;
+    uint8_t response[HEDERA_APDU_SIZE];
+    size_t received;
+    uint16_t status;
+
+    if (!transport->send(transport->user, apdu, length)) {
+        return HEDERA_STATUS_TRANSPORT;
+    }
+
+    received = transport->receive(transport->user, response, sizeof(response));
+    if (received < 2) {
+        return HEDERA_STATUS_TRANSPORT;
+    }
+
+    status = status_of(response, received);
+    if (status != HEDERA_SW_OK) {
+        return status;
+    }
+
+    if (received - 2 < expected) {
+        return HEDERA_STATUS_BAD_RESPONSE;
+    }
+
+    memmove(out, response, expected);
+
+    return status;
+}
+
+uint16_t hedera_get_configuration(
+    struct hedera_client_t* client,
+    /* out */ struct hedera_configuration_t* configuration
+) {
+    uint8_t apdu[OFFSET_CDATA];
+    uint8_t data[4];
+    uint16_t status = exchange(
+        client,
+        apdu,
+        build_apdu(apdu, INS_GET_APP_CONFIGURATION, 0, NULL, 0),
+        data,
+        sizeof(data)
+    );
+
+    // data[0] is the unused "storage allowed" flag
+    if (status == HEDERA_SW_OK) {
+        configuration->major = data[1];
+        configuration->minor = data[2];
+        configuration->patch = data[3];
+    }
+
+    return status;
+}
+
+uint16_t hedera_get_public_key(
+    struct hedera_client_t* client,
+    uint32_t index,
+    bool silent,
+    /* out */ uint8_t key[HEDERA_PUBLIC_KEY_SIZE]
+) {
+    uint8_t apdu[HEDERA_APDU_SIZE];
+
+    return exchange(
+        client,
+        apdu,
+        build_public_key(apdu, index, silent),
+        key,
+        HEDERA_PUBLIC_KEY_SIZE
+    );
+}
+
+uint16_t hedera_sign_transaction(
+    struct hedera_client_t* client,
+    uint32_t index,
+    const uint8_t* body,
+    size_t length,
+    /* out */ uint8_t signature[HEDERA_SIGNATURE_SIZE]
+) {
+    uint8_t apdu[HEDERA_APDU_SIZE];
+    size_t apdu_length = build_sign(apdu, index, body, length);
+
+    if (apdu_length == 0) {
+        return HEDERA_STATUS_TOO_LARGE;
+    }
+
+    return exchange(client, apdu, apdu_length, signature, HEDERA_SIGNATURE_SIZE);
+}
+
+// Adds a request to the end of the queue, to be sent on its own
+static struct hedera_request_t* enqueue(
+    struct hedera_client_t* client,
+    hedera_callback_t* callback,
+    void* user
+) {
+    struct hedera_request_t* request;
+
+    if (client->queued == HEDERA_QUEUE_SIZE) {
+        return NULL;
+    }
+
+    request = &client->queue[client->queued];
+    request->callback = callback;
+    request->user = user;
+    request->source = client->queued;
+
+    client->queued++;
+
+    return request;
+}
+
+bool hedera_submit_configuration(
+    struct hedera_client_t* client,
+    hedera_callback_t* callback,
+    void* user
+) {
+    struct hedera_request_t* request = enqueue(client, callback, user);
+
+    if (!request) {
+        return false;
+    }
+
+    request->length = build_apdu(request->apdu, INS_GET_APP_CONFIGURATION, 0, NULL, 0);
+
+    return true;
+}
+
+bool hedera_submit_public_key(
+    struct hedera_client_t* client,
+    uint32_t index,
+    bool silent,
+    hedera_callback_t* callback,
+    void* user
+) {
+    struct hedera_request_t* request = enqueue(client, callback, user);
+    size_t self;
+
+    if (!request) {
+        return false;
+    }
+
+    request->length = build_public_key(request->apdu, index, silent);
+    self = request->source;
+
+    // A silent lookup changes nothing on the device: one per key index
+    // answers them all. Prompted ones are each shown to the user.
+    if (silent) {
+        for (size_t i = 0; i < self; i++) {
+            const struct hedera_request_t* other = &client->queue[i];
+
+            if (other->source == i &&
+                other->length == request->length &&
+                memcmp(other->apdu, request->apdu, request->length) == 0) {
+                request->source = i;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool hedera_submit_sign(
+    struct hedera_client_t* client,
+    uint32_t index,
+    const uint8_t* body,
+    size_t length,
+    hedera_callback_t* callback,
+    void* user
+) {
+    struct hedera_request_t* request;
+
+    if (length > HEDERA_MAX_BODY_SIZE) {
+        return false;
+    }
+
+    request = enqueue(client, callback, user);
+    if (!request) {
+        return false;
+    }
+
+    request->length = build_sign(request->apdu, index, body, length);
+
+    return true;
+}
+
+bool hedera_submit_apdu(
+    struct hedera_client_t* client,
+    const uint8_t* apdu,
+    size_t length,
+    hedera_callback_t* callback,
+    void* user
+) {
+    struct hedera_request_t* request;
+
+    if (length > HEDERA_APDU_SIZE) {
+        return false;
+    }
+
+    request = enqueue(client, callback, user);
+    if (!request) {
+        return false;
+    }
+
+    memmove(request->apdu, apdu, length);
+    request->length = length;
+
+    return true;
+}
+
+// Calls back every request sharing the response of request `source`
+static void deliver(
+    struct hedera_client_t* client,
+    size_t source,
+    uint16_t status,
+    const uint8_t* data,
+    size_t length
+) {
+    for (size_t i = source; i < client->queued; i++) {
+        const struct hedera_request_t* request = &client->queue[i];
+
+        if (request->source == source && request->callback) {
+            request->callback(request->user, status, data, length);
+        }
+    }
+}
+
+size_t hedera_flush(struct hedera_client_t* client) {
+    struct hedera_transport_t* transport = client->transport;
+    unsigned int depth = transport->depth ? transport->depth : 1;
+    size_t sources[HEDERA_QUEUE_SIZE];
+    size_t source_count = 0;
+    size_t sent = 0;
+    size_t answered = 0;
+    bool failed = false;
+
+    for (size_t i = 0; i < client->queued; i++) {
+        if (client->queue[i].source == i) {
+            sources[source_count++] = i;
+        }
+    }
+
+    while (answered < source_count) {
+        uint8_t response[HEDERA_APDU_SIZE];
+        size_t received;
+
+        // Keep the pipeline full
+        while (sent < source_count && sent - answered < depth) {
+            const struct hedera_request_t* request = &client->queue[sources[sent]];
+
+            if (!transport->send(transport->user, request->apdu, request->length)) {
+                failed = true;
+                break;
+            }
+            sent++;
+        }
+
+        if (failed || sent == answered) {
+            break;
+        }
+
+        received = transport->receive(transport->user, response, sizeof(response));
+        if (received < 2) {
+            failed = true;
+            break;
+        }
+
+        deliver(
+            client,
+            sources[answered],
+            status_of(response, received),
+            response,
+            received - 2
+        );
+        answered++;
+    }
+
+    for (size_t i = answered; i < source_count; i++) {
+        deliver(client, sources[i], HEDERA_STATUS_TRANSPORT, NULL, 0);
+    }
+
+    client->queued = 0;
+
+    return answered;
+}
@@ -0,0 +1,181 @@
+#ifndef LEDGER_HEDERA_CLIENT_H
+#define LEDGER_HEDERA_CLIENT_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Client for the Hedera app: typed calls for its commands, over a socket
+// (hedera_device, Speculos) or USB HID reports from any HID library.
+//
+//     struct hedera_transport_t transport;
+//     struct hedera_client_t client;
+//     uint8_t key[HEDERA_PUBLIC_KEY_SIZE];
+//
+//     hedera_socket_open(&transport, "127.0.0.1:9999");
+//     hedera_client_init(&client, &transport);
+//     if (hedera_get_public_key(&client, 0, true, key) == HEDERA_SW_OK) ...
+//     transport.close(transport.user);
+//
+// Calls return the status word of the response, or one of the
+// HEDERA_STATUS_* codes below 0x100 when no response was had.
+//
+// Requests can also be queued with hedera_submit_* and sent together with
+// hedera_flush, which keeps up to transport.depth of them in flight and
+// sends only one silent key lookup for each key index queued.
+
+#define HEDERA_PUBLIC_KEY_SIZE 32
+#define HEDERA_SIGNATURE_SIZE 64
+
+// Largest body a single SIGN_TRANSACTION APDU carries, after the key index
+#define HEDERA_MAX_BODY_SIZE (255 - 4)
+
+// Status words of the app (src/errors.h)
+#define HEDERA_SW_OK 0x9000
+#define HEDERA_SW_USER_REJECTED 0x6985
+#define HEDERA_SW_UNKNOWN_INS 0x6D00
+#define HEDERA_SW_MALFORMED_APDU 0x6E00
+
+// Outcomes without a status word
+#define HEDERA_STATUS_TRANSPORT 0x0001     // the transport failed
+#define HEDERA_STATUS_TOO_LARGE 0x0002     // body over HEDERA_MAX_BODY_SIZE
+#define HEDERA_STATUS_BAD_RESPONSE 0x0003  // response of the wrong length
+
+#define HEDERA_APDU_SIZE 260
+#define HEDERA_QUEUE_SIZE 64
+
+// Carries whole APDUs to and from the device
+struct hedera_transport_t {
+    // Sends a request APDU; false if the transport failed
+    bool (*send)(void* user, const uint8_t* apdu, size_t length);
+
+    // Receives the next response APDU, data then status word; returns its
+    // length, or 0 if the transport failed
+    size_t (*receive)(void* user, uint8_t* apdu, size_t size);
+
+    void (*close)(void* user);
+
+    // Requests that may be sent before the first is answered; 1 for
+    // transports that must wait for each response
+    unsigned int depth;
+
+    void* user;
+};
+
+// Connects to host:port, or to a Unix socket path, speaking the framing of
+// hedera_device and Speculos' APDU port. Depth is 8; false on error.
+extern bool hedera_socket_open(struct hedera_transport_t* transport, const char* address);
+
+// USB HID reports of 64 bytes, moved by the caller's HID library. Reports
+// have no report ID byte here; add one in write_report if the library
+// needs it.
+struct hedera_hid_t {
+    // Writes one report; false on error
+    bool (*write_report)(void* user, const uint8_t report[64]);
+
+    // Reads one report; false on error or timeout
+    bool (*read_report)(void* user, uint8_t report[64]);
+
+    void (*close)(void* user);
+
+    void* user;
+};
+
+// Frames APDUs into HID reports as the device expects (channel 0x0101,
+// tag 0x05, sequence numbers, length in the first report). hid must stay
+// valid while the transport is used. Depth is 1.
+extern void hedera_hid_transport(struct hedera_transport_t* transport, struct hedera_hid_t* hid);
+
+struct hedera_configuration_t {
+    uint8_t major;
+    uint8_t minor;
+    uint8_t patch;
+};
+
+// Called with the status and response data of a submitted request
+typedef void hedera_callback_t(void* user, uint16_t status, const uint8_t* data, size_t length);
+
+struct hedera_request_t {
+    uint8_t apdu[HEDERA_APDU_SIZE];
+    size_t length;
+    hedera_callback_t* callback;
+    void* user;
+
+    // Index of the queued request whose response this one shares, or its
+    // own index
+    size_t source;
+};
+
+struct hedera_client_t {
+    struct hedera_transport_t* transport;
+
+    struct hedera_request_t queue[HEDERA_QUEUE_SIZE];
+    size_t queued;
+};
+
+extern void hedera_client_init(struct hedera_client_t* client, struct hedera_transport_t* transport);
+
+extern uint16_t hedera_get_configuration(
+    struct hedera_client_t* client,
+    /* out */ struct hedera_configuration_t* configuration
+);
+
+// Without silent, the user is asked to approve the export on the device
+extern uint16_t hedera_get_public_key(
+    struct hedera_client_t* client,
+    uint32_t index,
+    bool silent,
+    /* out */ uint8_t key[HEDERA_PUBLIC_KEY_SIZE]
+);
+
+// Signs a serialized TransactionBody with key index, once the user approves
+// it on the device
+extern uint16_t hedera_sign_transaction(
+    struct hedera_client_t* client,
+    uint32_t index,
+    const uint8_t* body,
+    size_t length,
+    /* out */ uint8_t signature[HEDERA_SIGNATURE_SIZE]
+);
+
+// Queue a request; false if the queue is full or the body too large.
+// Nothing is sent until hedera_flush.
+extern bool hedera_submit_configuration(
+    struct hedera_client_t* client,
+    hedera_callback_t* callback,
+    void* user
+);
+
+extern bool hedera_submit_public_key(
+    struct hedera_client_t* client,
+    uint32_t index,
+    bool silent,
+    hedera_callback_t* callback,
+    void* user
+);
+
+extern bool hedera_submit_sign(
+    struct hedera_client_t* client,
+    uint32_t index,
+    const uint8_t* body,
+    size_t length,
+    hedera_callback_t* callback,
+    void* user
+);
+
+// Queues a request APDU as is, for commands without a call above
+extern bool hedera_submit_apdu(
+    struct hedera_client_t* client,
+    const uint8_t* apdu,
+    size_t length,
+    hedera_callback_t* callback,
+    void* user
+);
+
+// Sends the queue, pipelined up to the transport's depth, calling each
+// request's callback as its response arrives. If the transport fails, the
+// rest are called with HEDERA_STATUS_TRANSPORT. Returns the number of
+// APDUs answered, which shared lookups make fewer than the requests.
+extern size_t hedera_flush(struct hedera_client_t* client);
+
+#endif // LEDGER_HEDERA_CLIENT_H
@@ -0,0 +1,440 @@
+#include <errno.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "farm.h"
+
+// A pool of devices behind one socket, scheduled by farm.h.
+//
+//     hedera_farm [options] -t [host:]port | -u path device...
+//
+// Each device is host:port or a Unix socket path, optionally followed by
+// =first-last for the key indexes it holds (all of them by default).
+// Clients speak the framing of hedera_device and Speculos' APDU port and
+// may pipeline their requests: those of one client are spread over the
+// devices, answered in the order they were sent. While every device a
+// request may go to is full, the farm stops reading from its client.
+//
+// Options:
+//
+//     -q jobs     most jobs queued on a device (32)
+//     -w jobs     most queued on a device while it is reviewing (1)
+//     -h ms       idle time before a device's health check (1000)
+//     -v          log clients and a report of the devices every 10 seconds
+//
+// SIGUSR1 prints a report of the devices; SIGINT and SIGTERM print it and
+// exit.
+
+// Requests of one client read ahead of its oldest unanswered one
+#define WINDOW 64
+
+#define REPORT_INTERVAL 10
+
+struct connection_t {
+    int fd;
+    struct hedera_farm_t* farm;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+
+    // Submitted jobs in the order they were read
+    struct hedera_farm_job_t* jobs[WINDOW];
+    size_t first;
+    size_t count;
+    bool closed;
+};
+
+static bool verbose;
+
+static bool read_all(int fd, uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = read(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+static bool write_all(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = write(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+// Writes responses in request order as they are answered
+static void* write_responses(void* user) {
+    struct connection_t* connection = user;
+    bool writable = true;
+
+    for (;;) {
+        struct hedera_farm_job_t* job;
+        uint8_t frame[4 + HEDERA_APDU_SIZE];
+        size_t data_length;
+
+        pthread_mutex_lock(&connection->lock);
+        while (connection->count == 0 && !connection->closed) {
+            pthread_cond_wait(&connection->changed, &connection->lock);
+        }
+
+        if (connection->count == 0) {
+            pthread_mutex_unlock(&connection->lock);
+            break;
+        }
+
+        job = connection->jobs[connection->first];
+        pthread_mutex_unlock(&connection->lock);
+
+        hedera_farm_wait(connection->farm, job);
+
+        // One write per response, as hedera_device does
+        data_length = job->response_length - 2;
+        frame[0] = data_length >> 24;
+        frame[1] = data_length >> 16;
+        frame[2] = data_length >> 8;
+        frame[3] = data_length;
+        memmove(frame + 4, job->response, job->response_length);
+
+        // A client gone away still has its jobs answered, and dropped
+        writable = writable && write_all(connection->fd, frame, 4 + job->response_length);
+
+        pthread_mutex_lock(&connection->lock);
+        connection->first = (connection->first + 1) % WINDOW;
+        connection->count--;
+        pthread_cond_broadcast(&connection->changed);
+        pthread_mutex_unlock(&connection->lock);
+
+        free(job);
+    }
+
+    return NULL;
+}
+
+// Reads a client's requests and submits them, then waits for the writer
+static void* serve(void* user) {
+    struct connection_t* connection = user;
+    pthread_t writer;
+
+    pthread_create(&writer, NULL, write_responses, connection);
+
+    for (;;) {
+        struct hedera_farm_job_t* job;
+        uint8_t header[4];
+        uint8_t apdu[HEDERA_APDU_SIZE];
+        uint32_t length;
+
+        if (!read_all(connection->fd, header, sizeof(header))) {
+            break;
+        }
+
+        length = (uint32_t) header[0] << 24 | header[1] << 16 | header[2] << 8 | header[3];
+        if (length > sizeof(apdu) || !read_all(connection->fd, apdu, length)) {
+            break;
+        }
+
+        job = malloc(sizeof(*job));
+        hedera_farm_job_init(job, apdu, length);
+
+        pthread_mutex_lock(&connection->lock);
+        while (connection->count == WINDOW) {
+            pthread_cond_wait(&connection->changed, &connection->lock);
+        }
+
+        connection->jobs[(connection->first + connection->count) % WINDOW] = job;
+        connection->count++;
+        pthread_cond_broadcast(&connection->changed);
+        pthread_mutex_unlock(&connection->lock);
+
+        // Waits while the devices are full, holding back further reads
+        hedera_farm_submit(connection->farm, job);
+    }
+
+    pthread_mutex_lock(&connection->lock);
+    connection->closed = true;
+    pthread_cond_broadcast(&connection->changed);
+    pthread_mutex_unlock(&connection->lock);
+
+    pthread_join(writer, NULL);
+
+    if (verbose) {
+        fprintf(stderr, "client disconnected\n");
+    }
+
+    close(connection->fd);
+    pthread_mutex_destroy(&connection->lock);
+    pthread_cond_destroy(&connection->changed);
+    free(connection);
+
+    return NULL;
+}
+
+struct signals_t {
+    struct hedera_farm_t* farm;
+    sigset_t set;
+};
+
+// Handles the signals blocked in every other thread
+static void* handle_signals(void* user) {
+    struct signals_t* signals = user;
+
+    for (;;) {
+        int signal;
+
+        if (sigwait(&signals->set, &signal) != 0) {
+            continue;
+        }
+
+        hedera_farm_report(signals->farm, stderr);
+
+        if (signal != SIGUSR1) {
+            exit(0);
+        }
+    }
+
+    return NULL;
+}
+
+static void* report_periodically(void* user) {
+    struct hedera_farm_t* farm = user;
+
+    for (;;) {
+        sleep(REPORT_INTERVAL);
+        hedera_farm_report(farm, stderr);
+    }
+
+    return NULL;
+}
+
+static int listen_tcp(const char* address) {
+    char host[256] = "127.0.0.1";
+    const char* port = address;
+    const char* colon = strrchr(address, ':');
+    struct addrinfo hints = {
+        .ai_family = AF_UNSPEC,
+        .ai_socktype = SOCK_STREAM,
+        .ai_flags = AI_PASSIVE,
+    };
+    struct addrinfo* info;
+    int one = 1;
+    int fd;
+
+    if (colon) {
+        snprintf(host, sizeof(host), "%.*s", (int) (colon - address), address);
+        port = colon + 1;
+    }
+
+    if (getaddrinfo(host, port, &hints, &info) != 0) {
+        fprintf(stderr, "bad address %s\n", address);
+        return -1;
+    }
+
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd >= 0) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (bind(fd, info->ai_addr, info->ai_addrlen) != 0 || listen(fd, 16) != 0) {
+            perror(address);
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    freeaddrinfo(info);
+
+    return fd;
+}
+
+static int listen_unix(const char* path) {
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    int fd;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return -1;
+    }
+
+    strcpy(address.sun_path, path);
+    unlink(path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 &&
+        (bind(fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(fd, 16) != 0)) {
+        perror(path);
+        close(fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+// address[=first-last]
+static bool add_device(struct hedera_farm_t* farm, const char* text) {
+    char address[108];
+    const char* equals = strchr(text, '=');
+    unsigned long first = 0;
+    unsigned long last = UINT32_MAX;
+
+    if (equals) {
+        char* end;
+
+        first = strtoul(equals + 1, &end, 10);
+        if (*end != '-') {
+            return false;
+        }
+
+        last = strtoul(end + 1, &end, 10);
+        if (*end != '\0' || first > last || last > UINT32_MAX) {
+            return false;
+        }
+    }
+
+    snprintf(address, sizeof(address), "%.*s", (int) (equals ? equals - text : strlen(text)), text);
+
+    return hedera_farm_add(farm, address, first, last);
+}
+
+static void usage() {
+    fprintf(
+        stderr,
+        "usage: hedera_farm [-q jobs] [-w jobs] [-h ms] [-v] -t [host:]port | -u path\n"
+        "                   device[=first-last]...\n"
+    );
+    exit(2);
+}
+
+int main(int argc, char* argv[]) {
+    static struct hedera_farm_t farm;
+    static struct signals_t signals;
+    pthread_t thread;
+    int server = -1;
+    int arg;
+
+    hedera_farm_init(&farm);
+
+    for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (argv[arg][1] == 'v') {
+            verbose = true;
+            continue;
+        }
+
+        if (arg + 1 == argc) {
+            usage();
+        }
+
+        switch (argv[arg][1]) {
+            case 'q':
+                farm.queue_limit = strtoul(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'w':
+                farm.review_limit = strtoul(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'h':
+                farm.health_interval_ms = strtoul(argv[arg + 1], NULL, 10);
+                break;
+
+            case 't':
+                server = listen_tcp(argv[arg + 1]);
+                break;
+
+            case 'u':
+                server = listen_unix(argv[arg + 1]);
+                break;
+
+            default:
+                usage();
+        }
+
+        if (server < 0 && (argv[arg][1] == 't' || argv[arg][1] == 'u')) {
+            return 1;
+        }
+
+        arg++;
+    }
+
+    if (arg == argc || server < 0 || farm.queue_limit == 0 || farm.health_interval_ms == 0) {
+        usage();
+    }
+
+    for (; arg < argc; arg++) {
+        if (!add_device(&farm, argv[arg])) {
+            fprintf(stderr, "bad device %s\n", argv[arg]);
+            return 1;
+        }
+    }
+
+    // Clients that disconnect mid-response are handled in write_responses(),
+    // and the signals in handle_signals()
+    signal(SIGPIPE, SIG_IGN);
+
+    signals.farm = &farm;
+    sigemptyset(&signals.set);
+    sigaddset(&signals.set, SIGINT);
+    sigaddset(&signals.set, SIGTERM);
+    sigaddset(&signals.set, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals.set, NULL);
+    pthread_create(&thread, NULL, handle_signals, &signals);
+    pthread_detach(thread);
+
+    hedera_farm_start(&farm);
+
+    if (verbose) {
+        hedera_farm_report(&farm, stderr);
+        pthread_create(&thread, NULL, report_periodically, &farm);
+        pthread_detach(thread);
+    }
+
+    for (;;) {
+        struct connection_t* connection;
+        int client = accept(server, NULL, NULL);
+
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("accept");
+            return 1;
+        }
+
+        if (verbose) {
+            fprintf(stderr, "client connected\n");
+        }
+
+        connection = calloc(1, sizeof(*connection));
+        connection->fd = client;
+        connection->farm = &farm;
+        pthread_mutex_init(&connection->lock, NULL);
+        pthread_cond_init(&connection->changed, NULL);
+
+        pthread_create(&thread, NULL, serve, connection);
+        pthread_detach(thread);
+    }
+}
@@ -0,0 +1,115 @@
+#include <string.h>
+
+#include "hedera_client.h"
+
+// Ledger's APDU framing over HID: each 64-byte report starts with the
+// channel (0x0101), the APDU tag (0x05) and a big-endian sequence number
+// from 0. The first report then carries the APDU's big-endian length.
+// Responses come back framed the same way.
+
+#define HID_REPORT_SIZE 64
+#define HID_CHANNEL 0x0101
+#define HID_TAG_APDU 0x05
+#define HID_HEADER_SIZE 5
+
+static bool hid_send(void* user, const uint8_t* apdu, size_t length) {
+    struct hedera_hid_t* hid = user;
+    size_t offset = 0;
+    uint16_t sequence = 0;
+
+    if (length > 0xFFFF) {
+        return false;
+    }
+
+    do {
+        uint8_t report[HID_REPORT_SIZE] = { 0 };
+        size_t header = HID_HEADER_SIZE;
+        size_t chunk;
+
+        report[0] = HID_CHANNEL >> 8;
+        report[1] = HID_CHANNEL & 0xFF;
+        report[2] = HID_TAG_APDU;
+        report[3] = sequence >> 8;
+        report[4] = sequence & 0xFF;
+
+        if (sequence == 0) {
+            report[5] = length >> 8;
+            report[6] = length & 0xFF;
+            header += 2;
+        }
+
+        chunk = length - offset;
+        if (chunk > HID_REPORT_SIZE - header) {
+            chunk = HID_REPORT_SIZE - header;
+        }
+
+        memmove(report + header, apdu + offset, chunk);
+        offset += chunk;
+        sequence++;
+
+        if (!hid->write_report(hid->user, report)) {
+            return false;
+        }
+    } while (offset < length);
+
+    return true;
+}
+
+static size_t hid_receive(void* user, uint8_t* apdu, size_t size) {
+    struct hedera_hid_t* hid = user;
+    size_t length = 0;
+    size_t offset = 0;
+    uint16_t sequence = 0;
+
+    do {
+        uint8_t report[HID_REPORT_SIZE];
+        size_t header = HID_HEADER_SIZE;
+        size_t chunk;
+
+        if (!hid->read_report(hid->user, report)) {
+            return 0;
+        }
+
+        if ((report[0] << 8 | report[1]) != HID_CHANNEL ||
+            report[2] != HID_TAG_APDU ||
+            (report[3] << 8 | report[4]) != sequence) {
+            return 0;
+        }
+
+        if (sequence == 0) {
+            length = report[5] << 8 | report[6];
+            header += 2;
+
+            if (length > size) {
+                return 0;
+            }
+        }
+
+        chunk = length - offset;
+        if (chunk > HID_REPORT_SIZE - header) {
+            chunk = HID_REPORT_SIZE - header;
+        }
+
+        memmove(apdu + offset, report + header, chunk);
+        offset += chunk;
+        sequence++;
+    } while (offset < length);
+
+    return length;
+}
+
+static void hid_close(void* user) {
+    struct hedera_hid_t* hid = user;
+
+    if (hid->close) {
+        hid->close(hid->user);
+    }
+}
+
+void hedera_hid_transport(struct hedera_transport_t* transport, struct hedera_hid_t* hid) {
+    transport->send = hid_send;
+    transport->receive = hid_receive;
+    transport->close = hid_close;
+    transport->depth = 1;
+    transport->user = hid;
+}
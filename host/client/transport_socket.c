@@ -0,0 +1,174 @@
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "hedera_client.h"
+
+// hedera_device and Speculos frame a request as a 4-byte big-endian length
+// and the APDU, and a response as a 4-byte big-endian length of its data,
+// the data, then the status word
+
+#define SOCKET_DEPTH 8
+
+struct socket_t {
+    int fd;
+};
+
+static bool write_all(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = write(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+static bool read_all(int fd, uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = read(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+static bool socket_send(void* user, const uint8_t* apdu, size_t length) {
+    struct socket_t* socket = user;
+    uint8_t frame[4 + HEDERA_APDU_SIZE];
+
+    if (length > HEDERA_APDU_SIZE) {
+        return false;
+    }
+
+    // One write per request, so pipelined requests leave together
+    frame[0] = length >> 24;
+    frame[1] = length >> 16;
+    frame[2] = length >> 8;
+    frame[3] = length;
+    memmove(frame + 4, apdu, length);
+
+    return write_all(socket->fd, frame, 4 + length);
+}
+
+static size_t socket_receive(void* user, uint8_t* apdu, size_t size) {
+    struct socket_t* socket = user;
+    uint8_t header[4];
+    uint32_t length;
+
+    if (!read_all(socket->fd, header, sizeof(header))) {
+        return 0;
+    }
+
+    length = (uint32_t) header[0] << 24 | header[1] << 16 | header[2] << 8 | header[3];
+    if (length + 2 > size || !read_all(socket->fd, apdu, length + 2)) {
+        return 0;
+    }
+
+    return length + 2;
+}
+
+static void socket_close(void* user) {
+    struct socket_t* socket = user;
+
+    close(socket->fd);
+    free(socket);
+}
+
+static int connect_tcp(const char* address, const char* colon) {
+    char host[256];
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo* info;
+    int one = 1;
+    int fd;
+
+    snprintf(host, sizeof(host), "%.*s", (int) (colon - address), address);
+    if (getaddrinfo(host, colon + 1, &hints, &info) != 0) {
+        return -1;
+    }
+
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd >= 0 && connect(fd, info->ai_addr, info->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(info);
+
+    if (fd >= 0) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    return fd;
+}
+
+static int connect_unix(const char* path) {
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    int fd;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+
+    strcpy(address.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+bool hedera_socket_open(struct hedera_transport_t* transport, const char* address) {
+    const char* colon = strrchr(address, ':');
+    struct socket_t* socket;
+    int fd;
+
+    // A path has a slash; host:port does not
+    if (colon && !strchr(address, '/')) {
+        fd = connect_tcp(address, colon);
+    } else {
+        fd = connect_unix(address);
+    }
+
+    if (fd < 0) {
+        return false;
+    }
+
+    socket = malloc(sizeof(*socket));
+    socket->fd = fd;
+
+    transport->send = socket_send;
+    transport->receive = socket_receive;
+    transport->close = socket_close;
+    transport->depth = SOCKET_DEPTH;
+    transport->user = socket;
+
+    return true;
+}
@@ -0,0 +1,420 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pb_encode.h>
+
+#include "globals.h"
+#include "TransactionBody.pb.h"
+
+// Writes a corpus of TransactionBody messages shaped like our traffic,
+// one raw body per file, encoded with the app's own descriptors:
+//
+//     hedera_corpus <directory>
+//
+// Files are named <kind>-<case>.bin. Every kind but "malformed" is a body
+// the app must review; "malformed" bodies it must refuse. hedera_decode
+// (host/decode_bench.c) reads the kinds back.
+
+#define BODY_SIZE 512
+#define MEMO_SIZE sizeof(((HederaTransactionBody*) 0)->memo)
+
+struct body_t {
+    uint8_t data[BODY_SIZE];
+    size_t length;
+};
+
+static const char* directory;
+static size_t written;
+
+static void write_body(const char* name, const struct body_t* body) {
+    char path[1024];
+    FILE* file;
+
+    snprintf(path, sizeof(path), "%s/%s.bin", directory, name);
+
+    file = fopen(path, "wb");
+    if (!file || fwrite(body->data, 1, body->length, file) != body->length) {
+        perror(path);
+        exit(1);
+    }
+
+    fclose(file);
+    written++;
+}
+
+// Raw wire format, for what the descriptors cannot express
+
+static void append(struct body_t* body, const uint8_t* data, size_t length) {
+    if (body->length + length > BODY_SIZE) {
+        fprintf(stderr, "body too large\n");
+        exit(1);
+    }
+
+    memmove(body->data + body->length, data, length);
+    body->length += length;
+}
+
+static void append_varint(struct body_t* body, uint64_t value) {
+    uint8_t buffer[10];
+    size_t length = 0;
+
+    do {
+        buffer[length] = value & 0x7f;
+        value >>= 7;
+        if (value) {
+            buffer[length] |= 0x80;
+        }
+        length++;
+    } while (value);
+
+    append(body, buffer, length);
+}
+
+static void append_key(struct body_t* body, uint32_t tag, pb_wire_type_t wire_type) {
+    append_varint(body, ((uint64_t) tag << 3) | wire_type);
+}
+
+static void append_bytes_field(struct body_t* body, uint32_t tag, const uint8_t* data, size_t length) {
+    append_key(body, tag, PB_WT_STRING);
+    append_varint(body, length);
+    append(body, data, length);
+}
+
+static void append_message_field(struct body_t* body, uint32_t tag, const struct body_t* message) {
+    append_bytes_field(body, tag, message->data, message->length);
+}
+
+// Messages through pb_encode
+
+static struct body_t encode(const pb_msgdesc_t* fields, const void* message) {
+    struct body_t body = { .length = 0 };
+    pb_ostream_t stream = pb_ostream_from_buffer(body.data, sizeof(body.data));
+
+    if (!pb_encode(&stream, fields, message)) {
+        fprintf(stderr, "pb_encode failed\n");
+        exit(1);
+    }
+
+    body.length = stream.bytes_written;
+
+    return body;
+}
+
+static HederaAccountID account(uint64_t shard, uint64_t realm, uint64_t num) {
+    HederaAccountID id = HederaAccountID_init_zero;
+
+    id.shardNum = shard;
+    id.realmNum = realm;
+    id.accountNum = num;
+
+    return id;
+}
+
+static HederaTransactionBody base_body(uint64_t fee, const char* memo) {
+    HederaTransactionBody body = HederaTransactionBody_init_zero;
+
+    body.has_transactionID = true;
+    body.transactionID.has_accountID = true;
+    body.transactionID.accountID = account(0, 0, 2);
+    body.transactionFee = fee;
+    strncpy(body.memo, memo, MEMO_SIZE - 1);
+
+    return body;
+}
+
+static HederaTransactionBody create_body(uint64_t fee, const char* memo, uint64_t balance) {
+    HederaTransactionBody body = base_body(fee, memo);
+
+    body.which_data = HederaTransactionBody_cryptoCreateAccount_tag;
+    body.data.cryptoCreateAccount.initialBalance = balance;
+
+    return body;
+}
+
+static void set_amount(HederaAccountAmount* amount, HederaAccountID id, int64_t tinybar) {
+    amount->has_accountID = true;
+    amount->accountID = id;
+    amount->amount = tinybar;
+}
+
+static HederaTransactionBody transfer_body(
+    uint64_t fee,
+    const char* memo,
+    HederaAccountID from,
+    HederaAccountID to,
+    int64_t tinybar
+) {
+    HederaTransactionBody body = base_body(fee, memo);
+    HederaTransferList* transfers = &body.data.cryptoTransfer.transfers;
+
+    body.which_data = HederaTransactionBody_cryptoTransfer_tag;
+    body.data.cryptoTransfer.has_transfers = true;
+    transfers->accountAmounts_count = 2;
+    set_amount(&transfers->accountAmounts[0], from, -tinybar);
+    set_amount(&transfers->accountAmounts[1], to, tinybar);
+
+    return body;
+}
+
+static HederaTransactionBody verify_body(HederaAccountID id) {
+    HederaTransactionBody body = base_body(1, "");
+    HederaTransferList* transfers = &body.data.cryptoTransfer.transfers;
+
+    body.which_data = HederaTransactionBody_cryptoTransfer_tag;
+    body.data.cryptoTransfer.has_transfers = true;
+    transfers->accountAmounts_count = 1;
+    set_amount(&transfers->accountAmounts[0], id, 0);
+
+    return body;
+}
+
+static void write_message(const char* name, HederaTransactionBody body) {
+    struct body_t encoded = encode(HederaTransactionBody_fields, &body);
+    write_body(name, &encoded);
+}
+
+// A ScheduleCreate wrapping the data, fee and memo of `inner`, as field 42
+// of an outer body with no data of its own, as the Hedera SDKs build them.
+// `memo` is the schedule's own, and `extra` is appended to the scheduled
+// body if given.
+static struct body_t schedule_body(
+    const HederaTransactionBody* inner,
+    const char* memo,
+    const struct body_t* extra
+) {
+    HederaTransactionBody outer = base_body(inner->transactionFee, "");
+    HederaSchedulableTransactionBody scheduled = HederaSchedulableTransactionBody_init_zero;
+    struct body_t body = encode(HederaTransactionBody_fields, &outer);
+    struct body_t schedule = { .length = 0 };
+    struct body_t encoded;
+
+    scheduled.transactionFee = inner->transactionFee;
+    memmove(scheduled.memo, inner->memo, sizeof(scheduled.memo));
+
+    if (inner->which_data == HederaTransactionBody_cryptoCreateAccount_tag) {
+        scheduled.which_data = HederaSchedulableTransactionBody_cryptoCreateAccount_tag;
+        scheduled.data.cryptoCreateAccount = inner->data.cryptoCreateAccount;
+    } else {
+        scheduled.which_data = HederaSchedulableTransactionBody_cryptoTransfer_tag;
+        scheduled.data.cryptoTransfer = inner->data.cryptoTransfer;
+    }
+
+    encoded = encode(HederaSchedulableTransactionBody_fields, &scheduled);
+    if (extra) {
+        append(&encoded, extra->data, extra->length);
+    }
+
+    append_message_field(&schedule, HederaScheduleCreateTransactionBody_scheduledTransactionBody_tag, &encoded);
+    if (memo[0] != '\0') {
+        append_bytes_field(&schedule, HederaScheduleCreateTransactionBody_memo_tag, (const uint8_t*) memo, strlen(memo));
+    }
+
+    append_message_field(&body, HederaTransactionBody_scheduleCreate_tag, &schedule);
+
+    return body;
+}
+
+// Fields of the full Hedera TransactionBody the app does not decode
+static void append_unknown_fields(struct body_t* body) {
+    static const uint8_t node_account[] = { 0x18, 0x03 };      // nodeAccountID 0.0.3
+    static const uint8_t valid_duration[] = { 0x08, 0x78 };    // 120 seconds
+    static const uint8_t fixed64[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    static const uint8_t fixed32[4] = { 1, 2, 3, 4 };
+
+    append_bytes_field(body, 2, node_account, sizeof(node_account));
+    append_bytes_field(body, 4, valid_duration, sizeof(valid_duration));
+    append_key(body, 5, PB_WT_VARINT);
+    append_varint(body, 1);
+    append_key(body, 99, PB_WT_64BIT);
+    append(body, fixed64, sizeof(fixed64));
+    append_key(body, 100, PB_WT_32BIT);
+    append(body, fixed32, sizeof(fixed32));
+}
+
+static void write_valid(const char* max_memo) {
+    const HederaAccountID max_id = account(UINT64_MAX, UINT64_MAX, UINT64_MAX);
+    HederaTransactionBody body;
+    struct body_t encoded;
+
+    write_message("create-basic", create_body(50000000, "new account", 2500000000ULL));
+    write_message("create-zero_balance", create_body(1, "", 0));
+    write_message("create-max_balance", create_body(UINT64_MAX, "", UINT64_MAX));
+    write_message("create-max_memo", create_body(100000000, max_memo, HBAR));
+
+    write_message("transfer-basic", transfer_body(100000000, "hello", account(0, 0, 2), account(0, 0, 3), HBAR));
+    write_message("transfer-one_tinybar", transfer_body(1, "", account(0, 0, 2), account(0, 0, 3), 1));
+    write_message("transfer-max_amount", transfer_body(UINT64_MAX, "", account(0, 0, 2), account(0, 0, 3), INT64_MAX));
+    write_message("transfer-max_ids", transfer_body(100000000, "", max_id, max_id, HBAR));
+    write_message("transfer-max_memo", transfer_body(100000000, max_memo, account(0, 0, 2), account(0, 0, 3), HBAR));
+
+    // Recipient listed first
+    write_message("transfer-recipient_first", transfer_body(100000000, "", account(0, 0, 3), account(0, 0, 2), -HBAR));
+
+    write_message("verify-basic", verify_body(account(0, 0, 2)));
+    write_message("verify-max_id", verify_body(max_id));
+
+    body = create_body(100000000, "scheduled", 2500000000ULL);
+    encoded = schedule_body(&body, "schedule", NULL);
+    write_body("schedule-create", &encoded);
+
+    body = transfer_body(100000000, "scheduled", account(0, 0, 2), account(0, 0, 3), HBAR);
+    encoded = schedule_body(&body, "schedule", NULL);
+    write_body("schedule-transfer", &encoded);
+
+    body = transfer_body(100000000, max_memo, account(0, 0, 2), account(0, 0, 3), HBAR);
+    encoded = schedule_body(&body, max_memo, NULL);
+    write_body("schedule-max_memo", &encoded);
+
+    // No fee or memos anywhere
+    body = transfer_body(0, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    encoded = schedule_body(&body, "", NULL);
+    write_body("schedule-bare", &encoded);
+
+    body = transfer_body(100000000, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    encoded = encode(HederaTransactionBody_fields, &body);
+    append_unknown_fields(&encoded);
+    write_body("unknown-top_level", &encoded);
+
+    // An unknown field inside the CryptoTransfer body
+    {
+        HederaCryptoTransferTransactionBody transfer = body.data.cryptoTransfer;
+        struct body_t inner = encode(HederaCryptoTransferTransactionBody_fields, &transfer);
+
+        body.which_data = 0;
+        encoded = encode(HederaTransactionBody_fields, &body);
+        append_key(&inner, 2, PB_WT_VARINT);
+        append_varint(&inner, 12345);
+        append_message_field(&encoded, HederaTransactionBody_cryptoTransfer_tag, &inner);
+        write_body("unknown-nested", &encoded);
+    }
+}
+
+static void write_malformed(const char* max_memo) {
+    HederaTransactionBody body = transfer_body(100000000, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    struct body_t valid = encode(HederaTransactionBody_fields, &body);
+    struct body_t encoded;
+    struct body_t extra;
+    char long_memo[MEMO_SIZE + 1];
+
+    encoded = valid;
+    encoded.length -= 5;
+    write_body("malformed-truncated", &encoded);
+
+    // Three accounts, over the decoder's limit of two
+    {
+        HederaAccountAmount amount = HederaAccountAmount_init_zero;
+        struct body_t one;
+        struct body_t list = { .length = 0 };
+        struct body_t transfer = { .length = 0 };
+
+        set_amount(&amount, account(0, 0, 2), -1);
+        one = encode(HederaAccountAmount_fields, &amount);
+        for (int i = 0; i < 3; i++) {
+            append_message_field(&list, 1, &one);
+        }
+        append_message_field(&transfer, 1, &list);
+
+        body.which_data = 0;
+        encoded = encode(HederaTransactionBody_fields, &body);
+        append_message_field(&encoded, HederaTransactionBody_cryptoTransfer_tag, &transfer);
+        write_body("malformed-three_accounts", &encoded);
+    }
+
+    // One character more than the memo holds
+    memset(long_memo, 'm', MEMO_SIZE);
+    long_memo[MEMO_SIZE] = '\0';
+    encoded = valid;
+    append_bytes_field(&encoded, HederaTransactionBody_memo_tag, (const uint8_t*) long_memo, MEMO_SIZE);
+    write_body("malformed-long_memo", &encoded);
+
+    // An eleven-byte varint
+    encoded = valid;
+    append_key(&encoded, HederaTransactionBody_transactionFee_tag, PB_WT_VARINT);
+    for (int i = 0; i < 10; i++) {
+        append(&encoded, (const uint8_t*) "\xff", 1);
+    }
+    append(&encoded, (const uint8_t*) "\x01", 1);
+    write_body("malformed-long_varint", &encoded);
+
+    // The fee as a string
+    encoded = valid;
+    append_bytes_field(&encoded, HederaTransactionBody_transactionFee_tag, (const uint8_t*) "1", 1);
+    write_body("malformed-wrong_wire_type", &encoded);
+
+    // A length running past the end of the body
+    encoded = valid;
+    append_key(&encoded, HederaTransactionBody_memo_tag, PB_WT_STRING);
+    append_varint(&encoded, 50);
+    append(&encoded, (const uint8_t*) max_memo, 10);
+    write_body("malformed-long_length", &encoded);
+
+    // No transaction data at all
+    write_message("malformed-no_data", base_body(100000000, "no data"));
+
+    encoded.length = 0;
+    write_body("malformed-empty", &encoded);
+
+    // Memos one character longer than nanopb accepts, in the schedule and
+    // in its body
+    body = transfer_body(100000000, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    encoded = schedule_body(&body, long_memo, NULL);
+    write_body("malformed-schedule_long_memo", &encoded);
+
+    extra.length = 0;
+    append_bytes_field(&extra, HederaSchedulableTransactionBody_memo_tag, (const uint8_t*) long_memo, MEMO_SIZE);
+    encoded = schedule_body(&body, "", &extra);
+    write_body("malformed-scheduled_long_memo", &encoded);
+
+    // A schedule memo sent as a varint
+    body = transfer_body(100000000, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    extra.length = 0;
+    append_key(&extra, HederaSchedulableTransactionBody_memo_tag, PB_WT_VARINT);
+    append_varint(&extra, 0);
+    encoded = schedule_body(&body, "", &extra);
+    write_body("malformed-scheduled_memo_varint", &encoded);
+
+    // A cryptoDelete (field 8) after the scheduled transfer
+    body = transfer_body(100000000, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    extra.length = 0;
+    append_key(&extra, 8, PB_WT_STRING);
+    append_varint(&extra, 0);
+    encoded = schedule_body(&body, "", &extra);
+    write_body("malformed-schedule_unknown_body", &encoded);
+
+    // A second scheduled transfer, repeating the oneof
+    valid = encode(HederaCryptoTransferTransactionBody_fields, &body.data.cryptoTransfer);
+    extra.length = 0;
+    append_message_field(&extra, HederaSchedulableTransactionBody_cryptoTransfer_tag, &valid);
+    encoded = schedule_body(&body, "", &extra);
+    write_body("malformed-schedule_repeated_body", &encoded);
+
+    // A schedule followed by an outer transfer, which replaces it
+    body = transfer_body(100000000, "", account(0, 0, 2), account(0, 0, 3), HBAR);
+    encoded = schedule_body(&body, "", NULL);
+    valid = encode(HederaTransactionBody_fields, &body);
+    append(&encoded, valid.data, valid.length);
+    write_body("malformed-schedule_then_transfer", &encoded);
+}
+
+int main(int argc, char* argv[]) {
+    char max_memo[MEMO_SIZE];
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: hedera_corpus <directory>\n");
+        return 2;
+    }
+
+    directory = argv[1];
+
+    // The longest memo nanopb accepts leaves room for the terminator
+    memset(max_memo, 'x', MEMO_SIZE - 1);
+    max_memo[MEMO_SIZE - 1] = '\0';
+
+    write_valid(max_memo);
+    write_malformed(max_memo);
+
+    printf("wrote %zu bodies to %s\n", written, directory);
+
+    return 0;
+}
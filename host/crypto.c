@@ -0,0 +1,643 @@
+#include <os.h>
+#include <cx.h>
+
+#include "host.h"
+
+// Reference SHA-512 (FIPS 180-4), SLIP-10 Ed25519 derivation and Ed25519
+// signing (RFC 8032) for the host build. The field and group arithmetic
+// follows TweetNaCl: small, constant-time enough for a test bench, and
+// slow. None of this is meant to protect a real key.
+
+// BIP-39 seed of the well-known test mnemonic "glory promote mansion idle
+// axis finger extra february uncover one trip resource lawn turtle enact
+// monster seven myth punch hobby comfort wild raise skin", so host keys
+// match those of an emulator or test device loaded with it
+static uint8_t host_seed[64] = {
+    0xb1, 0x19, 0x97, 0xfa, 0xff, 0x42, 0x0a, 0x33, 0x1b, 0xb4, 0xa4, 0xff,
+    0xdc, 0x8b, 0xdc, 0x8b, 0xa7, 0xc0, 0x17, 0x32, 0xa9, 0x9a, 0x30, 0xd8,
+    0x3d, 0xbb, 0xeb, 0xd4, 0x69, 0x66, 0x6c, 0x84, 0xb4, 0x7d, 0x09, 0xd3,
+    0xf5, 0xf4, 0x72, 0xb3, 0xb9, 0x38, 0x4a, 0xc6, 0x34, 0xbe, 0xba, 0x2a,
+    0x44, 0x0b, 0xa3, 0x6e, 0xc7, 0x66, 0x11, 0x44, 0x13, 0x2f, 0x35, 0xe2,
+    0x06, 0x87, 0x35, 0x64
+};
+static size_t host_seed_length = sizeof(host_seed);
+
+void host_set_seed(const uint8_t* seed, size_t length) {
+    if (length > sizeof(host_seed)) {
+        length = sizeof(host_seed);
+    }
+
+    memmove(host_seed, seed, length);
+    host_seed_length = length;
+}
+
+// SHA-512
+
+static const uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+typedef struct {
+    uint64_t state[8];
+    uint8_t block[128];
+    size_t block_length;
+    uint64_t length;
+} sha512_t;
+
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+static void sha512_compress(sha512_t* sha, const uint8_t* block) {
+    uint64_t w[80];
+    uint64_t v[8];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = 0;
+        for (int j = 0; j < 8; j++) {
+            w[i] = (w[i] << 8) | block[8 * i + j];
+        }
+    }
+
+    for (int i = 16; i < 80; i++) {
+        uint64_t s0 = ROTR64(w[i - 15], 1) ^ ROTR64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        uint64_t s1 = ROTR64(w[i - 2], 19) ^ ROTR64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    memmove(v, sha->state, sizeof(v));
+
+    for (int i = 0; i < 80; i++) {
+        uint64_t s1 = ROTR64(v[4], 14) ^ ROTR64(v[4], 18) ^ ROTR64(v[4], 41);
+        uint64_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+        uint64_t t1 = v[7] + s1 + ch + SHA512_K[i] + w[i];
+        uint64_t s0 = ROTR64(v[0], 28) ^ ROTR64(v[0], 34) ^ ROTR64(v[0], 39);
+        uint64_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+        uint64_t t2 = s0 + maj;
+
+        memmove(v + 1, v, 7 * sizeof(v[0]));
+        v[4] += t1;
+        v[0] = t1 + t2;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        sha->state[i] += v[i];
+    }
+}
+
+static void sha512_init(sha512_t* sha) {
+    static const uint64_t IV[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+        0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+        0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    memmove(sha->state, IV, sizeof(IV));
+    sha->block_length = 0;
+    sha->length = 0;
+}
+
+static void sha512_update(sha512_t* sha, const uint8_t* data, size_t length) {
+    sha->length += length;
+
+    while (length > 0) {
+        size_t n = sizeof(sha->block) - sha->block_length;
+        if (n > length) {
+            n = length;
+        }
+
+        memmove(sha->block + sha->block_length, data, n);
+        sha->block_length += n;
+        data += n;
+        length -= n;
+
+        if (sha->block_length == sizeof(sha->block)) {
+            sha512_compress(sha, sha->block);
+            sha->block_length = 0;
+        }
+    }
+}
+
+static void sha512_final(sha512_t* sha, uint8_t digest[64]) {
+    uint64_t bits = sha->length * 8;
+    uint8_t pad[128 + 16] = { 0x80 };
+    size_t pad_length = (sha->block_length < 112 ? 112 : 240) - sha->block_length;
+
+    // The length field is 128 bits; messages here are far below 2^64 bits
+    for (int i = 0; i < 8; i++) {
+        pad[pad_length + 8 + i] = bits >> (56 - 8 * i);
+    }
+    sha512_update(sha, pad, pad_length + 16);
+
+    for (int i = 0; i < 64; i++) {
+        digest[i] = sha->state[i / 8] >> (56 - 8 * (i % 8));
+    }
+}
+
+static void sha512(uint8_t digest[64], const uint8_t* data, size_t length) {
+    sha512_t sha;
+
+    sha512_init(&sha);
+    sha512_update(&sha, data, length);
+    sha512_final(&sha, digest);
+}
+
+static void hmac_sha512(
+    uint8_t mac[64],
+    const uint8_t* key,
+    size_t key_length,
+    const uint8_t* data,
+    size_t data_length
+) {
+    uint8_t pad[128] = { 0 };
+    uint8_t inner[64];
+    sha512_t sha;
+
+    if (key_length > sizeof(pad)) {
+        sha512(pad, key, key_length);
+    } else {
+        memmove(pad, key, key_length);
+    }
+
+    for (size_t i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36;
+    }
+    sha512_init(&sha);
+    sha512_update(&sha, pad, sizeof(pad));
+    sha512_update(&sha, data, data_length);
+    sha512_final(&sha, inner);
+
+    for (size_t i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    sha512_init(&sha);
+    sha512_update(&sha, pad, sizeof(pad));
+    sha512_update(&sha, inner, sizeof(inner));
+    sha512_final(&sha, mac);
+}
+
+// SLIP-10 derivation for Ed25519, where every level is hardened
+
+void os_perso_derive_node_bip32_seed_key(
+    unsigned int mode,
+    cx_curve_t curve,
+    const unsigned int* path,
+    unsigned int path_length,
+    unsigned char* private_key,
+    unsigned char* chain,
+    unsigned char* seed_key,
+    unsigned int seed_key_length
+) {
+    static const char ED25519_SEED[] = "ed25519 seed";
+    uint8_t node[64];
+    uint8_t data[1 + 32 + 4];
+
+    if (mode != HDW_ED25519_SLIP10 || curve != CX_CURVE_Ed25519) {
+        THROW(INVALID_PARAMETER);
+    }
+
+    if (seed_key == NULL) {
+        seed_key = (unsigned char*) ED25519_SEED;
+        seed_key_length = sizeof(ED25519_SEED) - 1;
+    }
+
+    hmac_sha512(node, seed_key, seed_key_length, host_seed, host_seed_length);
+
+    for (unsigned int i = 0; i < path_length; i++) {
+        uint32_t index = path[i] | 0x80000000;
+
+        data[0] = 0;
+        memmove(data + 1, node, 32);
+        data[33] = index >> 24;
+        data[34] = index >> 16;
+        data[35] = index >> 8;
+        data[36] = index;
+
+        // node[32..63] is the chain code, the HMAC key of the next level
+        hmac_sha512(node, node + 32, 32, data, sizeof(data));
+    }
+
+    if (private_key) {
+        memmove(private_key, node, 32);
+    }
+    if (chain) {
+        memmove(chain, node + 32, 32);
+    }
+
+    explicit_bzero(node, sizeof(node));
+    explicit_bzero(data, sizeof(data));
+}
+
+// Field arithmetic mod 2^255 - 19, sixteen 16-bit limbs
+
+typedef int64_t gf[16];
+
+static const gf GF0 = { 0 };
+static const gf GF1 = { 1 };
+static const gf D2 = {
+    0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+    0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406
+};
+static const gf BASE_X = {
+    0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+    0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169
+};
+static const gf BASE_Y = {
+    0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+    0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666
+};
+
+static void gf_copy(gf r, const gf a) {
+    for (int i = 0; i < 16; i++) {
+        r[i] = a[i];
+    }
+}
+
+static void gf_carry(gf o) {
+    for (int i = 0; i < 16; i++) {
+        int64_t c;
+
+        o[i] += (1LL << 16);
+        c = o[i] >> 16;
+        o[(i + 1) * (i < 15)] += c - 1 + 37 * (c - 1) * (i == 15);
+        o[i] -= c << 16;
+    }
+}
+
+static void gf_swap(gf p, gf q, int b) {
+    int64_t c = ~(b - 1);
+
+    for (int i = 0; i < 16; i++) {
+        int64_t t = c & (p[i] ^ q[i]);
+        p[i] ^= t;
+        q[i] ^= t;
+    }
+}
+
+static void gf_pack(uint8_t* o, const gf n) {
+    gf m, t;
+
+    gf_copy(t, n);
+    gf_carry(t);
+    gf_carry(t);
+    gf_carry(t);
+
+    for (int j = 0; j < 2; j++) {
+        int b;
+
+        m[0] = t[0] - 0xffed;
+        for (int i = 1; i < 15; i++) {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+            m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        b = (m[15] >> 16) & 1;
+        m[14] &= 0xffff;
+        gf_swap(t, m, 1 - b);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        o[2 * i] = t[i] & 0xff;
+        o[2 * i + 1] = t[i] >> 8;
+    }
+}
+
+static void gf_add(gf o, const gf a, const gf b) {
+    for (int i = 0; i < 16; i++) {
+        o[i] = a[i] + b[i];
+    }
+}
+
+static void gf_sub(gf o, const gf a, const gf b) {
+    for (int i = 0; i < 16; i++) {
+        o[i] = a[i] - b[i];
+    }
+}
+
+static void gf_mul(gf o, const gf a, const gf b) {
+    int64_t t[31] = { 0 };
+
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j < 16; j++) {
+            t[i + j] += a[i] * b[j];
+        }
+    }
+    for (int i = 0; i < 15; i++) {
+        t[i] += 38 * t[i + 16];
+    }
+    for (int i = 0; i < 16; i++) {
+        o[i] = t[i];
+    }
+
+    gf_carry(o);
+    gf_carry(o);
+}
+
+static void gf_inv(gf o, const gf i) {
+    gf c;
+
+    gf_copy(c, i);
+    for (int a = 253; a >= 0; a--) {
+        gf_mul(c, c, c);
+        if (a != 2 && a != 4) {
+            gf_mul(c, c, i);
+        }
+    }
+    gf_copy(o, c);
+}
+
+// Points in extended coordinates (X, Y, Z, T)
+
+static void point_add(gf p[4], gf q[4]) {
+    gf a, b, c, d, t, e, f, g, h;
+
+    gf_sub(a, p[1], p[0]);
+    gf_sub(t, q[1], q[0]);
+    gf_mul(a, a, t);
+    gf_add(b, p[0], p[1]);
+    gf_add(t, q[0], q[1]);
+    gf_mul(b, b, t);
+    gf_mul(c, p[3], q[3]);
+    gf_mul(c, c, D2);
+    gf_mul(d, p[2], q[2]);
+    gf_add(d, d, d);
+    gf_sub(e, b, a);
+    gf_sub(f, d, c);
+    gf_add(g, d, c);
+    gf_add(h, b, a);
+
+    gf_mul(p[0], e, f);
+    gf_mul(p[1], h, g);
+    gf_mul(p[2], g, f);
+    gf_mul(p[3], e, h);
+}
+
+static void point_swap(gf p[4], gf q[4], int b) {
+    for (int i = 0; i < 4; i++) {
+        gf_swap(p[i], q[i], b);
+    }
+}
+
+static void point_scalarmult(gf p[4], gf q[4], const uint8_t* s) {
+    gf_copy(p[0], GF0);
+    gf_copy(p[1], GF1);
+    gf_copy(p[2], GF1);
+    gf_copy(p[3], GF0);
+
+    for (int i = 255; i >= 0; i--) {
+        int b = (s[i / 8] >> (i & 7)) & 1;
+
+        point_swap(p, q, b);
+        point_add(q, p);
+        point_add(p, p);
+        point_swap(p, q, b);
+    }
+}
+
+static void point_scalarbase(gf p[4], const uint8_t* s) {
+    gf q[4];
+
+    gf_copy(q[0], BASE_X);
+    gf_copy(q[1], BASE_Y);
+    gf_copy(q[2], GF1);
+    gf_mul(q[3], BASE_X, BASE_Y);
+    point_scalarmult(p, q, s);
+}
+
+// Affine x and y of p, little-endian
+static void point_affine(uint8_t x[32], uint8_t y[32], gf p[4]) {
+    gf tx, ty, zi;
+
+    gf_inv(zi, p[2]);
+    gf_mul(tx, p[0], zi);
+    gf_mul(ty, p[1], zi);
+    gf_pack(x, tx);
+    gf_pack(y, ty);
+}
+
+// RFC 8032 encoding: y with the low bit of x in the top bit
+static void point_encode(uint8_t r[32], gf p[4]) {
+    uint8_t x[32];
+
+    point_affine(x, r, p);
+    r[31] ^= (x[0] & 1) << 7;
+}
+
+// Scalars mod L = 2^252 + 27742317777372353535851937790883648493
+
+static const int64_t L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2,
+    0xde, 0xf9, 0xde, 0x14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+};
+
+static void scalar_mod_l(uint8_t* r, int64_t x[64]) {
+    int64_t carry;
+
+    for (int i = 63; i >= 32; i--) {
+        int j;
+
+        carry = 0;
+        for (j = i - 32; j < i - 12; j++) {
+            x[j] += carry - 16 * x[i] * L[j - (i - 32)];
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry << 8;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+
+    carry = 0;
+    for (int j = 0; j < 32; j++) {
+        x[j] += carry - (x[31] >> 4) * L[j];
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+    for (int j = 0; j < 32; j++) {
+        x[j] -= carry * L[j];
+    }
+    for (int i = 0; i < 32; i++) {
+        x[i + 1] += x[i] >> 8;
+        r[i] = x[i] & 255;
+    }
+}
+
+static void scalar_reduce(uint8_t r[64]) {
+    int64_t x[64];
+
+    for (int i = 0; i < 64; i++) {
+        x[i] = r[i];
+    }
+    memset(r, 0, 64);
+    scalar_mod_l(r, x);
+}
+
+// Ed25519 secret scalar a and prefix from the 32-byte private key
+static void expand_private_key(uint8_t h[64], const uint8_t d[32]) {
+    sha512(h, d, 32);
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+}
+
+// cx API
+
+int cx_ecfp_init_private_key(
+    cx_curve_t curve,
+    const unsigned char* raw_key,
+    unsigned int key_len,
+    cx_ecfp_private_key_t* pvkey
+) {
+    if (curve != CX_CURVE_Ed25519 || (raw_key && key_len != 32)) {
+        THROW(INVALID_PARAMETER);
+    }
+
+    memset(pvkey, 0, sizeof(*pvkey));
+    pvkey->curve = curve;
+
+    if (raw_key) {
+        memmove(pvkey->d, raw_key, 32);
+        pvkey->d_len = 32;
+    }
+
+    return pvkey->d_len;
+}
+
+int cx_ecfp_init_public_key(
+    cx_curve_t curve,
+    const unsigned char* raw_key,
+    unsigned int key_len,
+    cx_ecfp_public_key_t* key
+) {
+    if (curve != CX_CURVE_Ed25519 || (raw_key && key_len != sizeof(key->W))) {
+        THROW(INVALID_PARAMETER);
+    }
+
+    memset(key, 0, sizeof(*key));
+    key->curve = curve;
+
+    if (raw_key) {
+        memmove(key->W, raw_key, sizeof(key->W));
+        key->W_len = sizeof(key->W);
+    }
+
+    return key->W_len;
+}
+
+int cx_ecfp_generate_pair(
+    cx_curve_t curve,
+    cx_ecfp_public_key_t* pubkey,
+    cx_ecfp_private_key_t* privkey,
+    int keepprivate
+) {
+    uint8_t h[64];
+    uint8_t x[32];
+    uint8_t y[32];
+    gf p[4];
+
+    // The host has no RNG-backed key generation; pairs come from a key
+    if (curve != CX_CURVE_Ed25519 || !keepprivate || privkey->d_len != 32) {
+        THROW(INVALID_PARAMETER);
+    }
+
+    expand_private_key(h, privkey->d);
+    point_scalarbase(p, h);
+    point_affine(x, y, p);
+
+    pubkey->curve = curve;
+    pubkey->W_len = sizeof(pubkey->W);
+    pubkey->W[0] = 0x04;
+    for (int i = 0; i < 32; i++) {
+        pubkey->W[1 + i] = x[31 - i];
+        pubkey->W[33 + i] = y[31 - i];
+    }
+
+    explicit_bzero(h, sizeof(h));
+
+    return 0;
+}
+
+int cx_eddsa_sign(
+    const cx_ecfp_private_key_t* pvkey,
+    int mode,
+    cx_md_t hashID,
+    const unsigned char* hash,
+    unsigned int hash_len,
+    const unsigned char* ctx,
+    unsigned int ctx_len,
+    unsigned char* sig,
+    unsigned int sig_len,
+    unsigned int* info
+) {
+    uint8_t h[64];
+    uint8_t r[64];
+    uint8_t k[64];
+    uint8_t public[32];
+    int64_t x[64];
+    gf p[4];
+    sha512_t sha;
+
+    UNUSED(mode);
+    UNUSED(ctx);
+    UNUSED(ctx_len);
+
+    if (hashID != CX_SHA512 || pvkey->d_len != 32 || sig_len < 64) {
+        THROW(INVALID_PARAMETER);
+    }
+
+    expand_private_key(h, pvkey->d);
+    point_scalarbase(p, h);
+    point_encode(public, p);
+
+    // r = H(prefix || M) mod L, R = rB
+    sha512_init(&sha);
+    sha512_update(&sha, h + 32, 32);
+    sha512_update(&sha, hash, hash_len);
+    sha512_final(&sha, r);
+    scalar_reduce(r);
+    point_scalarbase(p, r);
+    point_encode(sig, p);
+
+    // k = H(R || A || M) mod L, S = r + ka mod L
+    sha512_init(&sha);
+    sha512_update(&sha, sig, 32);
+    sha512_update(&sha, public, 32);
+    sha512_update(&sha, hash, hash_len);
+    sha512_final(&sha, k);
+    scalar_reduce(k);
+
+    for (int i = 0; i < 64; i++) {
+        x[i] = i < 32 ? r[i] : 0;
+    }
+    for (int i = 0; i < 32; i++) {
+        for (int j = 0; j < 32; j++) {
+            x[i + j] += (int64_t) k[i] * h[j];
+        }
+    }
+    scalar_mod_l(sig + 32, x);
+
+    if (info) {
+        *info = 0;
+    }
+
+    explicit_bzero(h, sizeof(h));
+    explicit_bzero(r, sizeof(r));
+
+    return 64;
+}
@@ -0,0 +1,253 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <os.h>
+
+#include "context.h"
+#include "sign_transaction.h"
+
+// Decode-plus-classify throughput over the corpus of host/corpus.c, per
+// kind of body:
+//
+//     hedera_decode [-n repeats] [-v] <corpus directory>
+//
+// Each body goes through decode_transaction and classify_transaction, as
+// in handle_sign_transaction, without signing or the review. Fails when a
+// "malformed" body is accepted or any other body is refused, so a decoder
+// change is checked and timed by the same run.
+
+#define ctx (G_command_context.sign_transaction)
+
+#define MAX_BODIES 256
+#define MAX_KINDS 16
+
+struct body_t {
+    char name[64];
+    uint8_t data[MAX_TX_SIZE];
+    size_t length;
+    size_t kind;
+    bool accepted;
+    uint64_t ns;
+};
+
+struct kind_t {
+    char name[32];
+    size_t bodies;
+    size_t bytes;
+    uint64_t ns;
+};
+
+static struct body_t bodies[MAX_BODIES];
+static size_t body_count;
+static struct kind_t kinds[MAX_KINDS];
+static size_t kind_count;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t find_kind(const char* name) {
+    char kind[sizeof(kinds[0].name)];
+    size_t length = strcspn(name, "-");
+
+    if (length >= sizeof(kind)) {
+        length = sizeof(kind) - 1;
+    }
+    memmove(kind, name, length);
+    kind[length] = '\0';
+
+    for (size_t i = 0; i < kind_count; i++) {
+        if (strcmp(kinds[i].name, kind) == 0) {
+            return i;
+        }
+    }
+
+    if (kind_count == MAX_KINDS) {
+        fprintf(stderr, "too many kinds of body\n");
+        exit(2);
+    }
+
+    strcpy(kinds[kind_count].name, kind);
+
+    return kind_count++;
+}
+
+static int compare_bodies(const void* a, const void* b) {
+    return strcmp(((const struct body_t*) a)->name, ((const struct body_t*) b)->name);
+}
+
+static void load(const char* directory) {
+    struct dirent* entry;
+    DIR* dir = opendir(directory);
+
+    if (!dir) {
+        perror(directory);
+        exit(2);
+    }
+
+    while ((entry = readdir(dir))) {
+        char path[1024];
+        struct body_t* body = &bodies[body_count];
+        size_t length = strlen(entry->d_name);
+        FILE* file;
+
+        if (length < 5 || strcmp(entry->d_name + length - 4, ".bin") != 0) {
+            continue;
+        }
+        if (body_count == MAX_BODIES) {
+            fprintf(stderr, "too many bodies\n");
+            exit(2);
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        file = fopen(path, "rb");
+        if (!file) {
+            perror(path);
+            exit(2);
+        }
+
+        body->length = fread(body->data, 1, sizeof(body->data), file);
+        fclose(file);
+
+        snprintf(body->name, sizeof(body->name), "%.*s", (int) (length - 4), entry->d_name);
+        body_count++;
+    }
+
+    closedir(dir);
+
+    qsort(bodies, body_count, sizeof(bodies[0]), compare_bodies);
+
+    for (size_t i = 0; i < body_count; i++) {
+        bodies[i].kind = find_kind(bodies[i].name);
+    }
+}
+
+static bool decode_and_classify(const struct body_t* body) {
+    volatile bool accepted = false;
+
+    BEGIN_TRY {
+        TRY {
+            decode_transaction(body->data, body->length);
+            classify_transaction();
+            accepted = true;
+        }
+        CATCH_ALL {
+            accepted = false;
+        }
+        FINALLY {
+            // explicitly do nothing
+        }
+    }
+    END_TRY;
+
+    return accepted;
+}
+
+int main(int argc, char* argv[]) {
+    long repeats = 100000;
+    bool verbose = false;
+    bool failed = false;
+    uint64_t total_ns = 0;
+    size_t total_bytes = 0;
+    int arg;
+
+    for (arg = 1; arg < argc - 1; arg++) {
+        if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc - 1) {
+            repeats = atol(argv[++arg]);
+        } else if (strcmp(argv[arg], "-v") == 0) {
+            verbose = true;
+        } else {
+            break;
+        }
+    }
+
+    if (arg != argc - 1 || repeats <= 0) {
+        fprintf(stderr, "usage: hedera_decode [-n repeats] [-v] <corpus directory>\n");
+        return 2;
+    }
+
+    load(argv[arg]);
+
+    if (body_count == 0) {
+        fprintf(stderr, "no bodies in %s\n", argv[arg]);
+        return 2;
+    }
+
+    for (size_t i = 0; i < body_count; i++) {
+        struct body_t* body = &bodies[i];
+        struct kind_t* kind = &kinds[body->kind];
+        bool malformed = strcmp(kind->name, "malformed") == 0;
+        uint64_t started;
+
+        memset(&G_command_context, 0, sizeof(G_command_context));
+
+        body->accepted = decode_and_classify(body);
+        if (body->accepted == malformed) {
+            fprintf(stderr, "%s: %s\n", body->name, malformed ? "accepted" : "refused");
+            failed = true;
+        }
+
+        started = now_ns();
+        for (long r = 0; r < repeats; r++) {
+            decode_and_classify(body);
+        }
+        body->ns = now_ns() - started;
+
+        kind->bodies++;
+        kind->bytes += body->length;
+        kind->ns += body->ns;
+        total_bytes += body->length;
+        total_ns += body->ns;
+
+        if (verbose) {
+            printf(
+                "%-40s %5zu bytes %8.1f ns %s\n",
+                body->name,
+                body->length,
+                (double) body->ns / repeats,
+                body->accepted ? "accepted" : "refused"
+            );
+        }
+    }
+
+    if (verbose) {
+        printf("\n");
+    }
+
+    printf("%-12s %8s %10s %10s %12s %10s\n", "kind", "bodies", "avg bytes", "ns/body", "bodies/s", "MB/s");
+
+    for (size_t i = 0; i < kind_count; i++) {
+        const struct kind_t* kind = &kinds[i];
+        double decodes = (double) kind->bodies * repeats;
+        double seconds = kind->ns / 1e9;
+
+        printf(
+            "%-12s %8zu %10.1f %10.1f %12.0f %10.1f\n",
+            kind->name,
+            kind->bodies,
+            (double) kind->bytes / kind->bodies,
+            kind->ns / decodes,
+            decodes / seconds,
+            kind->bytes * (double) repeats / seconds / 1e6
+        );
+    }
+
+    printf(
+        "%-12s %8zu %10.1f %10.1f %12.0f %10.1f\n",
+        "all",
+        body_count,
+        (double) total_bytes / body_count,
+        total_ns / ((double) body_count * repeats),
+        body_count * (double) repeats / (total_ns / 1e9),
+        total_bytes * (double) repeats / (total_ns / 1e9) / 1e6
+    );
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,554 @@
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ux.h>
+
+#include "host.h"
+#include "session.h"
+#include "trace.h"
+
+// A virtual device: the app served over a TCP or Unix socket, with the
+// review answered by a policy instead of a user.
+//
+//     hedera_device [options] -t [host:]port
+//     hedera_device [options] -u path
+//
+// APDUs use the framing of Speculos' APDU port, so its clients work
+// unchanged: a request is a 4-byte big-endian length and the APDU; a
+// response is a 4-byte big-endian length of the data, the data, then the
+// 2-byte status word. One client is served at a time; when it disconnects
+// the app restarts, as on a device unplugged and plugged back in.
+//
+// Options:
+//
+//     -p approve|reject|<percent>  answer to reviews and public key prompts:
+//                                  always, never, or that percent of them
+//     -s seed                      seed of the percent policy and jitter
+//     -f us                        time per 64-byte USB HID frame, each way
+//     -i INS=ms                    time the device spends on a command,
+//                                  repeatable (host time is negligible)
+//     -b ms                        time per button press of the user
+//     -j percent                   uniform jitter on each injected delay,
+//                                  up to 100
+//     -r trace.bin                 record the APDUs (host/trace.h), with
+//                                  responses stamped as they go out
+//     -v                           log each command to stderr
+//
+// Delays are 0 unless given, so the app runs at full host speed. Values for
+// a real device can be read back from its per-INS stats (GET_STATS).
+
+#define TICK_NS 100000000ULL
+
+// A USB HID APDU frame is 64 bytes: 7 bytes of header in the first frame,
+// 5 in the others
+#define HID_FRAME_SIZE 64
+#define HID_FIRST_HEADER 7
+#define HID_NEXT_HEADER 5
+
+// Presses a review may take before the policy gives up on it
+#define MAX_PRESSES 128
+
+enum Policy {
+    POLICY_APPROVE,
+    POLICY_REJECT,
+    POLICY_PERCENT
+};
+
+struct device_t {
+    int client;
+    bool verbose;
+
+    enum Policy policy;
+    unsigned int approve_percent;
+    unsigned int seed;
+
+    uint64_t frame_ns;
+    uint64_t button_ns;
+    uint64_t ins_ns[256];
+    unsigned int jitter_percent;
+    uint64_t jitter_state;  // splitmix64, apart from the policy's seed
+
+    // The command in flight
+    uint8_t ins;
+    size_t request_length;
+    uint64_t started;
+    unsigned int presses;
+    bool approving;
+
+    uint64_t last_tick;
+    unsigned long commands;
+
+    struct trace_writer_t trace;
+};
+
+static uint64_t now_ns() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// The device ticks every 100 ms; keep the app's tick count in step
+static void catch_up_ticks(struct device_t* device) {
+    uint64_t now = now_ns();
+
+    while (now - device->last_tick >= TICK_NS) {
+        device->last_tick += TICK_NS;
+        host_tick();
+    }
+}
+
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, bound), without the bias of a plain modulo
+static uint64_t uniform_below(uint64_t* state, uint64_t bound) {
+    uint64_t threshold = -bound % bound;
+    uint64_t value;
+
+    do {
+        value = splitmix64(state);
+    } while (value < threshold);
+
+    return value % bound;
+}
+
+static void inject(struct device_t* device, uint64_t ns) {
+    struct timespec ts;
+
+    if (ns == 0) {
+        return;
+    }
+
+    if (device->jitter_percent > 0) {
+        uint64_t spread = ns * device->jitter_percent / 100;
+
+        // ns - spread + [0, 2 * spread]
+        ns = ns - spread + uniform_below(&device->jitter_state, 2 * spread + 1);
+    }
+
+    ts.tv_sec = ns / 1000000000ULL;
+    ts.tv_nsec = ns % 1000000000ULL;
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+static uint64_t hid_frames(size_t length) {
+    if (length <= HID_FRAME_SIZE - HID_FIRST_HEADER) {
+        return 1;
+    }
+
+    length -= HID_FRAME_SIZE - HID_FIRST_HEADER;
+
+    return 1 + (length + HID_FRAME_SIZE - HID_NEXT_HEADER - 1) / (HID_FRAME_SIZE - HID_NEXT_HEADER);
+}
+
+// Reads exactly length bytes, ticking while the client is idle. False when
+// the client has gone.
+static bool read_all(struct device_t* device, uint8_t* data, size_t length) {
+    struct pollfd poll_fd = { .fd = device->client, .events = POLLIN };
+
+    while (length > 0) {
+        ssize_t count;
+
+        catch_up_ticks(device);
+
+        if (poll(&poll_fd, 1, TICK_NS / 1000000) == 0) {
+            continue;
+        }
+
+        count = read(device->client, data, length);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+static bool write_all(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = write(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+static size_t next_apdu(void* user, uint8_t* apdu, size_t size) {
+    struct device_t* device = user;
+    uint8_t header[4];
+    uint32_t length;
+
+    if (device->client < 0 || !read_all(device, header, sizeof(header))) {
+        return 0;
+    }
+
+    length = (uint32_t) header[0] << 24 | header[1] << 16 | header[2] << 8 | header[3];
+    if (length < 5 || length > size) {
+        fprintf(stderr, "bad APDU length %u, dropping the client\n", length);
+        return 0;
+    }
+
+    if (!read_all(device, apdu, length)) {
+        return 0;
+    }
+
+    if (device->trace.file) {
+        trace_command(&device->trace, apdu, length);
+    }
+
+    device->ins = apdu[1];
+    device->request_length = length;
+    device->started = now_ns();
+    device->presses = 0;
+
+    return length;
+}
+
+static void response(void* user, const uint8_t* apdu, size_t length) {
+    struct device_t* device = user;
+    uint8_t frame[4 + SESSION_APDU_SIZE];
+    size_t data_length = length - 2;
+
+    inject(
+        device,
+        device->ins_ns[device->ins] +
+        device->frame_ns * (hid_frames(device->request_length) + hid_frames(length))
+    );
+
+    // One write, so the client is not left waiting on a delayed ACK
+    frame[0] = data_length >> 24;
+    frame[1] = data_length >> 16;
+    frame[2] = data_length >> 8;
+    frame[3] = data_length;
+    memmove(frame + 4, apdu, length);
+
+    if (device->client >= 0 && !write_all(device->client, frame, 4 + length)) {
+        // next_apdu ends the session
+        close(device->client);
+        device->client = -1;
+    }
+
+    if (device->trace.file) {
+        // The device may be stopped at any time
+        trace_response(&device->trace, apdu, length);
+        fflush(device->trace.file);
+    }
+
+    device->commands++;
+
+    if (device->verbose) {
+        fprintf(
+            stderr,
+            "INS %02x: %02x%02x in %.3f ms, %u presses\n",
+            device->ins,
+            apdu[length - 2],
+            apdu[length - 1],
+            (now_ns() - device->started) / 1e6,
+            device->presses
+        );
+    }
+
+    catch_up_ticks(device);
+}
+
+static bool screen_is(const char* screen, const char* label) {
+    return strncmp(screen, label, strlen(label)) == 0;
+}
+
+// Pages through a prompt and answers it per the policy
+static unsigned int next_button(void* user) {
+    struct device_t* device = user;
+    const char* screen = host_screen();
+
+    if (device->presses == 0) {
+        switch (device->policy) {
+            case POLICY_APPROVE:
+                device->approving = true;
+                break;
+            case POLICY_REJECT:
+                device->approving = false;
+                break;
+            case POLICY_PERCENT:
+                device->approving = rand_r(&device->seed) % 100 < device->approve_percent;
+                break;
+        }
+    }
+
+    if (device->presses++ == MAX_PRESSES) {
+        fprintf(stderr, "no answer to [%s], dropping the client\n", screen);
+        return 0;
+    }
+
+    inject(device, device->button_ns);
+    catch_up_ticks(device);
+
+    if (screen_is(screen, "Export Public")) {
+        return device->approving ? BUTTON_RIGHT : BUTTON_LEFT;
+    }
+    if (screen_is(screen, "Confirm")) {
+        return device->approving ? BUTTON_LEFT | BUTTON_RIGHT : BUTTON_RIGHT;
+    }
+    if (screen_is(screen, "Deny")) {
+        return BUTTON_LEFT | BUTTON_RIGHT;
+    }
+
+    // Summary and fields of a review
+    return BUTTON_RIGHT;
+}
+
+static int listen_tcp(const char* address) {
+    char host[256] = "127.0.0.1";
+    const char* port = address;
+    const char* colon = strrchr(address, ':');
+    struct addrinfo hints = {
+        .ai_family = AF_UNSPEC,
+        .ai_socktype = SOCK_STREAM,
+        .ai_flags = AI_PASSIVE,
+    };
+    struct addrinfo* info;
+    int one = 1;
+    int fd;
+
+    if (colon) {
+        snprintf(host, sizeof(host), "%.*s", (int) (colon - address), address);
+        port = colon + 1;
+    }
+
+    if (getaddrinfo(host, port, &hints, &info) != 0) {
+        fprintf(stderr, "bad address %s\n", address);
+        return -1;
+    }
+
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd >= 0) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (bind(fd, info->ai_addr, info->ai_addrlen) != 0 || listen(fd, 1) != 0) {
+            perror(address);
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    freeaddrinfo(info);
+
+    return fd;
+}
+
+static int listen_unix(const char* path) {
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    int fd;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return -1;
+    }
+
+    strcpy(address.sun_path, path);
+    unlink(path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 &&
+        (bind(fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(fd, 1) != 0)) {
+        perror(path);
+        close(fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+static bool parse_ins_delay(struct device_t* device, const char* text) {
+    char* end;
+    unsigned long ins = strtoul(text, &end, 16);
+
+    if (*end != '=' || ins > 0xFF) {
+        return false;
+    }
+
+    device->ins_ns[ins] = strtod(end + 1, NULL) * 1e6;
+
+    return true;
+}
+
+static bool parse_policy(struct device_t* device, const char* text) {
+    char* end;
+
+    if (strcmp(text, "approve") == 0) {
+        device->policy = POLICY_APPROVE;
+    } else if (strcmp(text, "reject") == 0) {
+        device->policy = POLICY_REJECT;
+    } else {
+        device->policy = POLICY_PERCENT;
+        device->approve_percent = strtoul(text, &end, 10);
+
+        if (*end != '\0' || device->approve_percent > 100) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void usage() {
+    fprintf(
+        stderr,
+        "usage: hedera_device [-p approve|reject|percent] [-s seed] [-f us] [-i INS=ms]...\n"
+        "                     [-b ms] [-j percent] [-r trace.bin] [-v] -t [host:]port | -u path\n"
+    );
+    exit(2);
+}
+
+int main(int argc, char* argv[]) {
+    static struct device_t device;
+    struct host_io_t io = {
+        .next_apdu = next_apdu,
+        .response = response,
+        .next_button = next_button,
+        .user = &device,
+    };
+    int server = -1;
+    int arg;
+
+    device.client = -1;
+    device.seed = 1;
+
+    for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (argv[arg][1] == 'v') {
+            device.verbose = true;
+            continue;
+        }
+
+        if (arg + 1 == argc) {
+            usage();
+        }
+
+        switch (argv[arg][1]) {
+            case 'p':
+                if (!parse_policy(&device, argv[arg + 1])) {
+                    usage();
+                }
+                break;
+
+            case 's':
+                device.seed = strtoul(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'f':
+                device.frame_ns = strtod(argv[arg + 1], NULL) * 1e3;
+                break;
+
+            case 'i':
+                if (!parse_ins_delay(&device, argv[arg + 1])) {
+                    usage();
+                }
+                break;
+
+            case 'b':
+                device.button_ns = strtod(argv[arg + 1], NULL) * 1e6;
+                break;
+
+            case 'j':
+                device.jitter_percent = strtoul(argv[arg + 1], NULL, 10);
+                if (device.jitter_percent > 100) {
+                    usage();
+                }
+                break;
+
+            case 'r':
+                if (!trace_open(&device.trace, argv[arg + 1])) {
+                    perror(argv[arg + 1]);
+                    return 1;
+                }
+                break;
+
+            case 't':
+                server = listen_tcp(argv[arg + 1]);
+                break;
+
+            case 'u':
+                server = listen_unix(argv[arg + 1]);
+                break;
+
+            default:
+                usage();
+        }
+
+        if (server < 0 && (argv[arg][1] == 't' || argv[arg][1] == 'u')) {
+            return 1;
+        }
+
+        arg++;
+    }
+
+    if (arg != argc || server < 0) {
+        usage();
+    }
+
+    device.jitter_state = device.seed;
+
+    // A client that disconnects mid-response is handled in response()
+    signal(SIGPIPE, SIG_IGN);
+
+    device.last_tick = now_ns();
+
+    for (;;) {
+        device.client = accept(server, NULL, NULL);
+        if (device.client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("accept");
+            return 1;
+        }
+
+        if (device.verbose) {
+            fprintf(stderr, "client connected\n");
+        }
+
+        host_run(&io);
+
+        if (device.client >= 0) {
+            close(device.client);
+            device.client = -1;
+        }
+
+        if (device.verbose) {
+            fprintf(stderr, "client gone after %lu commands\n", device.commands);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Writes the SIGN_TRANSACTION bodies of recorded sessions as a C table.
+
+    bodies.py sessions/*.apdus > build/bodies.h
+
+Each body is named after its session, with its position when the session
+signs more than once.
+"""
+
+import os
+import sys
+
+INS_SIGN_TRANSACTION = 0x04
+
+
+def bodies_of(path):
+    name = os.path.splitext(os.path.basename(path))[0]
+    found = []
+
+    with open(path) as session:
+        for line in session:
+            line = line.strip()
+            if not line or line.startswith("#") or line.startswith("buttons"):
+                continue
+
+            apdu = bytes.fromhex(line.replace(" ", ""))
+            if len(apdu) > 9 and apdu[1] == INS_SIGN_TRANSACTION:
+                # Skip the header and the key index
+                found.append(apdu[9:])
+
+    if len(found) == 1:
+        return [(name, found[0])]
+    return [("%s_%d" % (name, i + 1), body) for i, body in enumerate(found)]
+
+
+def main():
+    print("// Generated by host/emu/bodies.py; do not edit")
+    print("static const struct body_t BODIES[] = {")
+
+    for path in sorted(sys.argv[1:]):
+        for name, body in bodies_of(path):
+            data = ", ".join("0x%02x" % byte for byte in body)
+            print('    { "%s", %d, { %s } },' % (name, len(body), data))
+
+    print("};")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
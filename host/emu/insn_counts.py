@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Instructions each operation of emu/ops.c executes under QEMU.
+
+    insn_counts.py --qemu qemu-system-arm --plugin libinsn.so \\
+        --elf build/cortex-m0plus/ops.elf --list ../build/hedera_ops \\
+        --baseline baseline_cortex-m0plus.json --threshold 2
+
+Every operation runs twice, set up and then repeated 0 and 1 times; the
+difference of the two totals is the cost of one run, without boot, setup
+or exit. TCG execution is deterministic, so the counts are exact and any
+change is a change in the code. Exits non-zero when an operation grows
+more than --threshold percent over the baseline, or fails to run.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+INSNS_RE = re.compile(r"insns: (\d+)")
+
+
+def list_operations(native):
+    output = subprocess.run(
+        [native, "list"], check=True, capture_output=True, text=True
+    ).stdout
+    return output.split()
+
+
+def count(args, operation, repeats):
+    with tempfile.NamedTemporaryFile(mode="r", suffix=".log") as log:
+        command = [
+            args.qemu,
+            "-M", "mps2-an385",
+            "-display", "none",
+            "-monitor", "none",
+            "-serial", "none",
+            "-semihosting-config",
+            "enable=on,target=native,arg=ops,arg=%s,arg=%d" % (operation, repeats),
+            "-kernel", args.elf,
+            "-plugin", args.plugin,
+            "-d", "plugin",
+            "-D", log.name,
+        ]
+
+        result = subprocess.run(command, capture_output=True, text=True, timeout=600)
+        if result.returncode != 0:
+            raise RuntimeError(
+                "%s exited with %d: %s" % (operation, result.returncode, result.stderr.strip())
+            )
+
+        # The plugin prints a total at exit, after any per-CPU lines
+        totals = INSNS_RE.findall(log.read())
+        if not totals:
+            raise RuntimeError("%s: no instruction count in the QEMU log" % operation)
+
+        return int(totals[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--qemu", default="qemu-system-arm")
+    parser.add_argument("--plugin", required=True)
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--list", required=True,
+                        help="native build of ops.c, to list the operations")
+    parser.add_argument("--baseline")
+    parser.add_argument("--save")
+    parser.add_argument("--threshold", type=float, default=2.0,
+                        help="percent growth allowed over the baseline")
+    args = parser.parse_args()
+
+    counts = {}
+    failed = False
+
+    for operation in list_operations(args.list):
+        try:
+            counts[operation] = count(args, operation, 1) - count(args, operation, 0)
+        except (RuntimeError, subprocess.TimeoutExpired) as error:
+            print(error)
+            failed = True
+
+    if args.save:
+        with open(args.save, "w") as baseline_file:
+            json.dump(counts, baseline_file, indent=1, sort_keys=True)
+        print("saved %d counts to %s" % (len(counts), args.save))
+        return 1 if failed else 0
+
+    baseline = {}
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as baseline_file:
+            baseline = json.load(baseline_file)
+
+    print("%s" % os.path.basename(os.path.dirname(os.path.abspath(args.elf))))
+    print("%-40s %12s %12s %8s" % ("operation", "insns", "baseline", "change"))
+
+    for operation, insns in counts.items():
+        old = baseline.get(operation)
+        if old is None:
+            print("%-40s %12d %12s %8s" % (operation, insns, "-", "new"))
+            continue
+
+        change = 100.0 * (insns - old) / old if old else 0.0
+        status = ""
+        if change > args.threshold:
+            status = " REGRESSED"
+            failed = True
+
+        print("%-40s %12d %12d %+7.1f%%%s" % (operation, insns, old, change, status))
+
+    for operation in sorted(set(baseline) - set(counts)):
+        print("%-40s %12s %12d %8s" % (operation, "-", baseline[operation], "removed"))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
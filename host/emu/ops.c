@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <os.h>
+
+#include "context.h"
+#include "globals.h"
+#include "hedera.h"
+#include "sign_transaction.h"
+
+// The operations whose instruction counts host/emu/insn_counts.py tracks.
+// Each is run as
+//
+//     ops <operation> <repeats>
+//
+// which sets the operation up and then runs it <repeats> times, so the
+// difference between 1 and 0 repeats is the cost of one run. "ops list"
+// prints the operations, one per line.
+//
+// The same program builds natively (make -C host) to check the list and
+// that every operation runs.
+
+#define ctx (G_command_context.sign_transaction)
+
+struct body_t {
+    const char* name;
+    size_t length;
+    uint8_t data[MAX_TX_SIZE];
+};
+
+#include "bodies.h"
+
+#define BODY_COUNT (sizeof(BODIES) / sizeof(BODIES[0]))
+
+static const struct {
+    const char* name;
+    uint64_t tinybar;
+} TINYBAR_VALUES[] = {
+    { "zero", 0 },
+    { "one_hbar", HBAR },
+    { "fraction", 123456789 },
+    { "max", UINT64_MAX }
+};
+
+#define TINYBAR_COUNT (sizeof(TINYBAR_VALUES) / sizeof(TINYBAR_VALUES[0]))
+
+static char text[ACCOUNT_ID_SIZE + HBAR_BUF_SIZE];
+
+// The conversion hedera_format_tinybar replaced: a 64-bit division by ten
+// per digit, as "%llu" does. Its count is the reference for the
+// division-free one.
+static void format_tinybar_divide(char* dst, uint64_t tinybar) {
+    uint64_t hbar = tinybar / HBAR;
+    uint32_t fraction = tinybar % HBAR;
+    char digits[20];
+    size_t count = 0;
+    size_t len = 0;
+
+    do {
+        digits[count++] = '0' + hbar % 10;
+        hbar /= 10;
+    } while (hbar != 0);
+
+    while (count > 0) {
+        dst[len++] = digits[--count];
+    }
+
+    if (fraction != 0) {
+        dst[len++] = '.';
+        for (uint32_t power = HBAR / 10; fraction != 0; power /= 10) {
+            dst[len++] = '0' + fraction / power;
+            fraction %= power;
+        }
+    }
+
+    dst[len] = '\0';
+}
+
+static bool decode(const struct body_t* body) {
+    volatile bool decoded = false;
+
+    BEGIN_TRY {
+        TRY {
+            decode_transaction(body->data, body->length);
+            decoded = true;
+        }
+        CATCH_ALL {
+            decoded = false;
+        }
+        FINALLY {
+            // explicitly do nothing
+        }
+    }
+    END_TRY;
+
+    return decoded;
+}
+
+// Decodes and classifies the body, leaving it formatted for review
+static bool review(const struct body_t* body) {
+    volatile bool reviewed = false;
+
+    if (!decode(body)) {
+        return false;
+    }
+
+    BEGIN_TRY {
+        TRY {
+            handle_transaction_body();
+            reviewed = true;
+        }
+        CATCH_ALL {
+            reviewed = false;
+        }
+        FINALLY {
+            // explicitly do nothing
+        }
+    }
+    END_TRY;
+
+    return reviewed;
+}
+
+// Every page of every field of the review
+static void reformat_pages() {
+    for (uint8_t step = Operator; step <= ScheduleMemo; step++) {
+        if (ctx.fields[step - Operator].title == NULL) {
+            continue;
+        }
+
+        ctx.step = step;
+        ctx.display_count = num_screens(ctx.fields[step - Operator].length);
+
+        for (ctx.display_index = 1; ctx.display_index <= ctx.display_count; ctx.display_index++) {
+            reformat_page();
+        }
+    }
+}
+
+enum OpKind {
+    OP_DECODE,
+    OP_REVIEW,
+    OP_FORMAT_FIELDS,
+    OP_REFORMAT_PAGE,
+    OP_SIGN,
+    OP_FORMAT_TINYBAR,
+    OP_FORMAT_TINYBAR_DIVIDE,
+    OP_FORMAT_ENTITY_ID,
+    OP_REFORMAT_TITLE,
+    OP_DERIVE_KEYPAIR
+};
+
+static const char* const OP_NAMES[] = {
+    [OP_DECODE] = "decode",
+    [OP_REVIEW] = "review",
+    [OP_FORMAT_FIELDS] = "format_fields",
+    [OP_REFORMAT_PAGE] = "reformat_page",
+    [OP_SIGN] = "sign_stub",
+    [OP_FORMAT_TINYBAR] = "format_tinybar",
+    [OP_FORMAT_TINYBAR_DIVIDE] = "format_tinybar_divide",
+    [OP_FORMAT_ENTITY_ID] = "format_entity_id",
+    [OP_REFORMAT_TITLE] = "reformat_title",
+    [OP_DERIVE_KEYPAIR] = "derive_keypair_stub"
+};
+
+// Sets the operation up; false if it does not apply to its argument
+static bool setup(enum OpKind kind, size_t arg) {
+    memset(&G_command_context, 0, sizeof(G_command_context));
+
+    switch (kind) {
+        case OP_REVIEW:
+        case OP_FORMAT_FIELDS:
+        case OP_REFORMAT_PAGE:
+            return review(&BODIES[arg]);
+
+        case OP_REFORMAT_TITLE:
+            ctx.display_index = 2;
+            ctx.display_count = 5;
+            return true;
+
+        default:
+            return true;
+    }
+}
+
+static void run(enum OpKind kind, size_t arg) {
+    static cx_ecfp_private_key_t secret;
+    static cx_ecfp_public_key_t public;
+    static uint8_t signature[64];
+
+    switch (kind) {
+        case OP_DECODE:
+            decode(&BODIES[arg]);
+            break;
+
+        case OP_REVIEW:
+            handle_transaction_body();
+            break;
+
+        case OP_FORMAT_FIELDS:
+            format_fields();
+            break;
+
+        case OP_REFORMAT_PAGE:
+            reformat_pages();
+            break;
+
+        case OP_SIGN:
+            hedera_sign(0, BODIES[arg].data, BODIES[arg].length, signature);
+            break;
+
+        case OP_FORMAT_TINYBAR:
+            hedera_format_tinybar(text, sizeof(text), TINYBAR_VALUES[arg].tinybar);
+            break;
+
+        case OP_FORMAT_TINYBAR_DIVIDE:
+            format_tinybar_divide(text, TINYBAR_VALUES[arg].tinybar);
+            break;
+
+        case OP_FORMAT_ENTITY_ID:
+            hedera_format_entity_id(text, sizeof(text), 0, 0, arg ? UINT64_MAX : 3);
+            break;
+
+        case OP_REFORMAT_TITLE:
+            reformat_title("Recipient");
+            break;
+
+        case OP_DERIVE_KEYPAIR:
+            hedera_derive_keypair(0, &secret, &public);
+            break;
+    }
+}
+
+// Number of arguments (bodies or values) an operation takes
+static size_t arg_count(enum OpKind kind) {
+    switch (kind) {
+        case OP_FORMAT_TINYBAR:
+        case OP_FORMAT_TINYBAR_DIVIDE:
+            return TINYBAR_COUNT;
+
+        case OP_FORMAT_ENTITY_ID:
+            return 2;
+
+        case OP_REFORMAT_TITLE:
+        case OP_DERIVE_KEYPAIR:
+            return 1;
+
+        default:
+            return BODY_COUNT;
+    }
+}
+
+static void op_name(char* dst, size_t size, enum OpKind kind, size_t arg) {
+    switch (kind) {
+        case OP_FORMAT_TINYBAR:
+        case OP_FORMAT_TINYBAR_DIVIDE:
+            snprintf(dst, size, "%s/%s", OP_NAMES[kind], TINYBAR_VALUES[arg].name);
+            break;
+
+        case OP_FORMAT_ENTITY_ID:
+            snprintf(dst, size, "%s/%s", OP_NAMES[kind], arg ? "max" : "short");
+            break;
+
+        case OP_REFORMAT_TITLE:
+        case OP_DERIVE_KEYPAIR:
+            snprintf(dst, size, "%s", OP_NAMES[kind]);
+            break;
+
+        default:
+            snprintf(dst, size, "%s/%s", OP_NAMES[kind], BODIES[arg].name);
+            break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    char name[64];
+    bool list;
+    long repeats;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: ops list | ops <operation> <repeats>\n");
+        return 2;
+    }
+
+    list = strcmp(argv[1], "list") == 0;
+    repeats = argc > 2 ? atol(argv[2]) : 1;
+
+    for (size_t kind = 0; kind < sizeof(OP_NAMES) / sizeof(OP_NAMES[0]); kind++) {
+        for (size_t arg = 0; arg < arg_count(kind); arg++) {
+            op_name(name, sizeof(name), kind, arg);
+
+            if (list) {
+                // Only operations that apply to their body are listed
+                if (setup(kind, arg)) {
+                    printf("%s\n", name);
+                }
+                continue;
+            }
+
+            if (strcmp(name, argv[1]) != 0) {
+                continue;
+            }
+
+            if (!setup(kind, arg)) {
+                fprintf(stderr, "%s does not apply\n", name);
+                return 3;
+            }
+
+            for (long i = 0; i < repeats; i++) {
+                run(kind, arg);
+            }
+
+            return 0;
+        }
+    }
+
+    if (list) {
+        return 0;
+    }
+
+    fprintf(stderr, "unknown operation %s\n", argv[1]);
+    return 2;
+}
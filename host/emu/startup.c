@@ -0,0 +1,26 @@
+// Vector table for the QEMU mps2-an385 board: the stack top and the reset
+// handler, which hands over to the newlib/rdimon C runtime. Faults stop
+// the emulator through semihosting so a crash cannot hang a run.
+
+extern unsigned long __StackTop;
+extern void _start(void);
+extern void _exit(int status);
+
+static void fault_handler(void) {
+    _exit(128);
+}
+
+static void reset_handler(void) {
+    _start();
+}
+
+__attribute__((section(".isr_vector"), used))
+static void (* const vectors[16])(void) = {
+    (void (*)(void)) &__StackTop,
+    reset_handler,
+    fault_handler,  // NMI
+    fault_handler,  // HardFault
+    fault_handler,  // MemManage
+    fault_handler,  // BusFault
+    fault_handler,  // UsageFault
+};
@@ -0,0 +1,137 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "globals.h"
+#include "hedera.h"
+
+// The division-free formatters of hedera.c against the C library's
+// snprintf, on each side of every power of ten and at the 64-bit limits,
+// in full and truncated to every shorter buffer.
+//
+//     make -C host test
+
+static int failures;
+
+// snprintf's rendering of an amount: "%llu", then ".%08llu" with the
+// trailing zeros of the fraction trimmed
+static void expected_tinybar(char* dst, size_t size, uint64_t tinybar) {
+    int len = snprintf(dst, size, "%" PRIu64, tinybar / HBAR);
+
+    if (tinybar % HBAR != 0) {
+        len += snprintf(dst + len, size - len, ".%08" PRIu64, tinybar % HBAR);
+
+        while (dst[len - 1] == '0') {
+            dst[--len] = '\0';
+        }
+    }
+}
+
+// Compares a formatter's output with the expected text, and its output
+// into every shorter buffer with the matching prefix
+static void check(
+    const char* what,
+    uint64_t value,
+    const char* expected,
+    size_t (*format)(char* dst, size_t size, const void* arg),
+    const void* arg
+) {
+    char text[128];
+
+    for (size_t size = strlen(expected) + 1; size > 0; size--) {
+        size_t len;
+
+        memset(text, '#', sizeof(text));
+        len = format(text, size, arg);
+
+        if (len != size - 1 || strncmp(text, expected, len) != 0 || text[len] != '\0') {
+            fprintf(
+                stderr,
+                "%s(%" PRIu64 ") into %zu: [%.*s] (%zu), expected [%.*s]\n",
+                what,
+                value,
+                size,
+                (int) len,
+                text,
+                len,
+                (int) size - 1,
+                expected
+            );
+            failures++;
+            return;
+        }
+    }
+
+    // Nothing is written into an empty buffer
+    text[0] = '#';
+    if (format(text, 0, arg) != 0 || text[0] != '#') {
+        fprintf(stderr, "%s(%" PRIu64 ") wrote into an empty buffer\n", what, value);
+        failures++;
+    }
+}
+
+static size_t format_tinybar(char* dst, size_t size, const void* arg) {
+    return hedera_format_tinybar(dst, size, *(const uint64_t*) arg);
+}
+
+static size_t format_hbar(char* dst, size_t size, const void* arg) {
+    return hedera_format_hbar(dst, size, *(const uint64_t*) arg);
+}
+
+static size_t format_entity_id(char* dst, size_t size, const void* arg) {
+    const uint64_t* id = arg;
+
+    return hedera_format_entity_id(dst, size, id[0], id[1], id[2]);
+}
+
+static void check_amount(uint64_t tinybar) {
+    char expected[64];
+
+    expected_tinybar(expected, sizeof(expected), tinybar);
+    check("hedera_format_tinybar", tinybar, expected, format_tinybar, &tinybar);
+
+    strcat(expected, " hbar");
+    check("hedera_format_hbar", tinybar, expected, format_hbar, &tinybar);
+}
+
+static void check_entity_id(uint64_t shard, uint64_t realm, uint64_t num) {
+    const uint64_t id[] = { shard, realm, num };
+    char expected[3 * 21];
+
+    snprintf(expected, sizeof(expected), "%" PRIu64 ".%" PRIu64 ".%" PRIu64, shard, realm, num);
+    check("hedera_format_entity_id", num, expected, format_entity_id, id);
+}
+
+int main() {
+    uint64_t power = 1;
+
+    // 10^k - 1, 10^k and 10^k + 1 for every power that fits
+    for (int k = 0; k <= 19; k++) {
+        for (int delta = -1; delta <= 1; delta++) {
+            uint64_t value = power + delta;
+
+            check_amount(value);
+            check_entity_id(0, 0, value);
+            check_entity_id(value, value, value);
+        }
+
+        if (k < 19) {
+            power *= 10;
+        }
+    }
+
+    check_amount(0);
+    check_amount(HBAR - 1);
+    check_amount(HBAR + 1);
+    check_amount(150000000);
+    check_amount(UINT64_MAX - 1);
+    check_amount(UINT64_MAX);
+
+    check_entity_id(0, 0, 0);
+    check_entity_id(UINT64_MAX, UINT64_MAX, UINT64_MAX);
+    check_entity_id(UINT64_MAX, 0, UINT64_MAX - 1);
+
+    printf("%-24s %s\n", "format", failures ? "FAIL" : "ok");
+
+    return failures ? 1 : 0;
+}
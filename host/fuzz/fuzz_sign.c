@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <os.h>
+#include <ux.h>
+
+#include "context.h"
+#include "errors.h"
+#include "handlers.h"
+#include "sign_transaction.h"
+
+// libFuzzer target for the signing command. Each input is the data of a
+// sign APDU, a little-endian key index and the TransactionBody, and goes
+// through handle_sign_transaction as main.c would hand it over; accepted
+// bodies are then paged through to the Confirm step, so every field the
+// review formats is read. Inputs run in one process, one after another.
+//
+// ASan catches reads and writes outside any buffer; the checks below catch
+// what it cannot see inside G_command_context, exceptions other than a
+// refused APDU, and stack use over FUZZ_STACK_LIMIT.
+
+#define ctx (G_command_context.sign_transaction)
+
+// Bytes of stack the app may use below the harness. Host frames are larger
+// than Thumb ones, and ASan pads them further, so this is a guard against
+// unbounded recursion rather than the device budget (make stack-usage).
+#ifndef FUZZ_STACK_LIMIT
+#define FUZZ_STACK_LIMIT (64 * 1024)
+#endif
+
+// Right presses that page through the longest review, with room to spare
+#define MAX_PRESSES 64
+
+// The app is compiled with -finstrument-functions: every function entry
+// lowers the mark to its frame
+static uintptr_t stack_entry;
+static uintptr_t stack_lowest;
+static uintptr_t stack_peak;
+
+__attribute__((no_instrument_function))
+void __cyg_profile_func_enter(void* function, void* caller) {
+    uintptr_t frame = (uintptr_t) __builtin_frame_address(0);
+
+    if (frame < stack_lowest) {
+        stack_lowest = frame;
+    }
+}
+
+__attribute__((no_instrument_function))
+void __cyg_profile_func_exit(void* function, void* caller) {
+}
+
+static void fail(const char* message) {
+    fprintf(stderr, "fuzz_sign: %s\n", message);
+    abort();
+}
+
+static bool terminated(const char* text, size_t size) {
+    return memchr(text, '\0', size) != NULL;
+}
+
+// What ASan cannot see: the review's text stays within its own arrays
+static void check_review() {
+    if (!terminated(ctx.summary_line_1, sizeof(ctx.summary_line_1)) ||
+        !terminated(ctx.summary_line_2, sizeof(ctx.summary_line_2)) ||
+        !terminated(ctx.title, sizeof(ctx.title)) ||
+        !terminated(ctx.partial, sizeof(ctx.partial))) {
+        fail("unterminated review text");
+    }
+
+    if (ctx.values_length > sizeof(ctx.values)) {
+        fail("review values overflow");
+    }
+
+    for (uint8_t step = Operator; step <= ScheduleMemo; step++) {
+        const struct review_field_t* field = &ctx.fields[step - Operator];
+
+        if (field->title == NULL) {
+            continue;
+        }
+
+        // Memos are paged in place from buffers of the same size
+        if (step == Memo || step == ScheduledMemo || step == ScheduleMemo) {
+            if (field->length >= sizeof(ctx.transaction.memo)) {
+                fail("memo overflow");
+            }
+        } else if (field->text < ctx.values ||
+                   field->text + field->length > ctx.values + ctx.values_length) {
+            fail("field outside the review values");
+        }
+    }
+}
+
+// Right presses up to the Confirm step, checking each page on the way
+static void page_to_confirm() {
+    for (int press = 0; ctx.step != Confirm; press++) {
+        if (press == MAX_PRESSES) {
+            fail("review never reaches Confirm");
+        }
+
+        ux.button_push_handler(BUTTON_EVT_RELEASED | BUTTON_RIGHT, 0);
+        check_review();
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    volatile unsigned int flags = 0;
+    volatile unsigned int tx = 0;
+    volatile bool accepted = false;
+    uint8_t* buffer;
+
+    // The APDU length is one byte
+    if (size > 255) {
+        return 0;
+    }
+
+    // A buffer of exactly the input, so ASan sees any read past it
+    buffer = malloc(size);
+    if (size > 0) {
+        memmove(buffer, data, size);
+    }
+
+    memset(&G_command_context, 0, sizeof(G_command_context));
+    memset(&ux, 0, sizeof(ux));
+
+    stack_entry = (uintptr_t) __builtin_frame_address(0);
+    stack_lowest = stack_entry;
+
+    BEGIN_TRY {
+        TRY {
+            handle_sign_transaction(0, 0, buffer, size, &flags, &tx);
+            accepted = true;
+        }
+        CATCH(EXCEPTION_MALFORMED_APDU) {
+            accepted = false;
+        }
+        CATCH_OTHER(e) {
+            fprintf(stderr, "fuzz_sign: exception 0x%x\n", e);
+            abort();
+        }
+        FINALLY {
+            // explicitly do nothing
+        }
+    }
+    END_TRY;
+
+    if (accepted) {
+        if (!(flags & IO_ASYNCH_REPLY) || ctx.step != Summary) {
+            fail("accepted without starting the review");
+        }
+
+        check_review();
+        page_to_confirm();
+    }
+
+    if (stack_entry - stack_lowest > stack_peak) {
+        stack_peak = stack_entry - stack_lowest;
+
+        if (stack_peak > FUZZ_STACK_LIMIT) {
+            fprintf(stderr, "fuzz_sign: %lu bytes of stack\n", (unsigned long) stack_peak);
+            abort();
+        }
+    }
+
+    free(buffer);
+
+    return 0;
+}
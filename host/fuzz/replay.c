@@ -0,0 +1,80 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Runs files, or every file in directories, through the fuzz target once
+// each, for compilers without libFuzzer (ENGINE=replay). Crashes and
+// corpus entries found by libFuzzer replay the same way under gdb.
+
+extern int LLVMFuzzerTestOneInput(const unsigned char* data, size_t size);
+
+static unsigned long inputs;
+
+static void replay_file(const char* path) {
+    static unsigned char data[4096];
+    size_t size;
+    FILE* file = fopen(path, "rb");
+
+    if (!file) {
+        perror(path);
+        exit(2);
+    }
+
+    size = fread(data, 1, sizeof(data), file);
+    fclose(file);
+
+    LLVMFuzzerTestOneInput(data, size);
+    inputs++;
+}
+
+static void replay(const char* path) {
+    struct stat info;
+    struct dirent* entry;
+    DIR* dir;
+
+    if (stat(path, &info) != 0) {
+        perror(path);
+        exit(2);
+    }
+
+    if (!S_ISDIR(info.st_mode)) {
+        replay_file(path);
+        return;
+    }
+
+    dir = opendir(path);
+    if (!dir) {
+        perror(path);
+        exit(2);
+    }
+
+    while ((entry = readdir(dir))) {
+        char child[1024];
+
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        replay(child);
+    }
+
+    closedir(dir);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file or directory>...\n", argv[0]);
+        return 2;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        replay(argv[i]);
+    }
+
+    printf("%lu inputs\n", inputs);
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "host.h"
+#include "session.h"
+#include "trace.h"
+
+// Runs an APDU session from stdin against the app:
+//
+//     e0 02 00 00 04 00000000   request APDU in hex, spaces optional
+//     buttons RRRRRRB           presses for the next UI prompt: Left,
+//                               Right or Both, or l and r to hold Left or
+//                               Right until it repeats fast
+//     # comment
+//
+// and prints each response in hex. With -v it also prints each screen
+// before a button is pressed, and -r trace.bin records the APDUs in the
+// format of host/trace.h.
+
+#define LINE_SIZE 1024
+
+struct prompt_t {
+    char buttons[SESSION_BUTTONS_SIZE];
+    size_t button_count;
+    size_t button_next;
+    bool verbose;
+    struct trace_writer_t trace;
+};
+
+static size_t next_apdu(void* user, uint8_t* apdu, size_t size) {
+    struct prompt_t* prompt = user;
+    char line[LINE_SIZE];
+
+    while (fgets(line, sizeof(line), stdin)) {
+        char* text = line;
+        size_t length;
+        int count;
+
+        while (isspace((unsigned char) *text)) {
+            text++;
+        }
+        if (*text == '\0' || *text == '#') {
+            continue;
+        }
+
+        count = session_parse_buttons(text, prompt->buttons, sizeof(prompt->buttons));
+        if (count >= 0) {
+            prompt->button_count = count;
+            prompt->button_next = 0;
+            continue;
+        }
+
+        length = session_parse_hex(text, apdu, size);
+        if (length == 0) {
+            fprintf(stderr, "bad APDU: %s", line);
+            continue;
+        }
+
+        printf("=> ");
+        for (size_t i = 0; i < length; i++) {
+            printf("%02x", apdu[i]);
+        }
+        printf("\n");
+
+        if (prompt->trace.file) {
+            trace_command(&prompt->trace, apdu, length);
+        }
+
+        return length;
+    }
+
+    return 0;
+}
+
+static void response(void* user, const uint8_t* apdu, size_t length) {
+    struct prompt_t* prompt = user;
+
+    printf("<= ");
+    for (size_t i = 0; i < length; i++) {
+        printf("%02x", apdu[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+
+    if (prompt->trace.file) {
+        trace_response(&prompt->trace, apdu, length);
+    }
+}
+
+static unsigned int next_button(void* user) {
+    struct prompt_t* prompt = user;
+
+    if (prompt->verbose) {
+        printf("   [%s]\n", host_screen());
+    }
+
+    if (prompt->button_next == prompt->button_count) {
+        fprintf(stderr, "out of buttons on [%s]\n", host_screen());
+        return 0;
+    }
+
+    return session_button_mask(prompt->buttons[prompt->button_next++]);
+}
+
+int main(int argc, char* argv[]) {
+    static struct prompt_t prompt;
+    struct host_io_t io = {
+        .next_apdu = next_apdu,
+        .response = response,
+        .next_button = next_button,
+        .user = &prompt,
+    };
+
+    for (int arg = 1; arg < argc; arg++) {
+        if (strcmp(argv[arg], "-v") == 0) {
+            prompt.verbose = true;
+        } else if (strcmp(argv[arg], "-r") == 0 && arg + 1 < argc) {
+            if (!trace_open(&prompt.trace, argv[++arg])) {
+                perror(argv[arg]);
+                return 2;
+            }
+        } else {
+            fprintf(stderr, "usage: hedera_host [-v] [-r trace.bin] < session.apdus\n");
+            return 2;
+        }
+    }
+
+    host_run(&io);
+
+    trace_close(&prompt.trace);
+
+    return 0;
+}
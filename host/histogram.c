@@ -0,0 +1,72 @@
+#include "histogram.h"
+
+static size_t histogram_bucket(uint64_t value) {
+    int msb;
+    int shift;
+    size_t bucket;
+
+    if (value < 2 * HISTOGRAM_SUB) {
+        return value;
+    }
+
+    msb = 63 - __builtin_clzll(value);
+    shift = msb - HISTOGRAM_SUB_BITS;
+    bucket = (shift + 1) * HISTOGRAM_SUB + (value >> shift) - HISTOGRAM_SUB;
+
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+// Middle of the values in a bucket
+static uint64_t histogram_value(size_t bucket) {
+    int shift;
+
+    if (bucket < 2 * HISTOGRAM_SUB) {
+        return bucket;
+    }
+
+    shift = bucket / HISTOGRAM_SUB - 1;
+
+    return ((uint64_t) (bucket % HISTOGRAM_SUB + HISTOGRAM_SUB) << shift)
+        + ((1ULL << shift) >> 1);
+}
+
+void histogram_add(struct histogram_t* histogram, uint64_t value) {
+    histogram->counts[histogram_bucket(value)]++;
+    histogram->total++;
+
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+void histogram_merge(struct histogram_t* into, const struct histogram_t* from) {
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        into->counts[i] += from->counts[i];
+    }
+
+    into->total += from->total;
+
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+}
+
+uint64_t histogram_percentile(const struct histogram_t* histogram, double percent) {
+    uint64_t rank = (uint64_t) (histogram->total * percent / 100.0);
+    uint64_t seen = 0;
+
+    if (rank >= histogram->total) {
+        return histogram->max;
+    }
+
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen > rank) {
+            // The middle of the last bucket can lie above the largest value
+            uint64_t value = histogram_value(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
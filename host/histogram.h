@@ -0,0 +1,26 @@
+#ifndef LEDGER_HEDERA_HOST_HISTOGRAM_H
+#define LEDGER_HEDERA_HOST_HISTOGRAM_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Latencies in ns, 32 buckets per power of two (about 3% resolution)
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS (HISTOGRAM_SUB * 40)
+
+struct histogram_t {
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+};
+
+extern void histogram_add(struct histogram_t* histogram, uint64_t value);
+
+// Adds the values of from into into
+extern void histogram_merge(struct histogram_t* into, const struct histogram_t* from);
+
+// Value below which percent of the values fall, to the bucket resolution
+extern uint64_t histogram_percentile(const struct histogram_t* histogram, double percent);
+
+#endif // LEDGER_HEDERA_HOST_HISTOGRAM_H
@@ -0,0 +1,42 @@
+#ifndef LEDGER_HEDERA_HOST_H
+#define LEDGER_HEDERA_HOST_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Runs the app on the host (make -C host). A driver supplies request APDUs
+// and the buttons to press when the app waits on the UI, and receives the
+// response APDUs, as a USB host and a user would.
+
+struct host_io_t {
+    // Copies the next request APDU into apdu and returns its length, or 0
+    // to end the session
+    size_t (*next_apdu)(void* user, uint8_t* apdu, size_t size);
+
+    // A response APDU: data followed by the status word
+    void (*response)(void* user, const uint8_t* apdu, size_t length);
+
+    // Next button mask to press and release (BUTTON_LEFT, BUTTON_RIGHT or
+    // both) while a command waits on the UI, or 0 to end the session. With
+    // BUTTON_EVT_FAST the buttons are held long enough to repeat fast.
+    unsigned int (*next_button)(void* user);
+
+    void* user;
+};
+
+// Boots the app and runs app_main until the driver ends the session
+extern void host_run(const struct host_io_t* io);
+
+// Delivers a SEPROXYHAL ticker event, as the device does every 100 ms
+extern void host_tick();
+
+// Text of the labels on screen, joined with " | "
+extern const char* host_screen();
+
+// Replaces the BIP-39 seed keys are derived from (see host/crypto.c)
+extern void host_set_seed(const uint8_t* seed, size_t length);
+
+// Defined in src/main.c
+extern void app_main();
+
+#endif // LEDGER_HEDERA_HOST_H
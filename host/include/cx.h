@@ -0,0 +1,72 @@
+#ifndef LEDGER_HEDERA_HOST_CX_H
+#define LEDGER_HEDERA_HOST_CX_H 1
+
+// Host stand-in for the BOLOS cx.h: Ed25519 only, backed by host/crypto.c
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    CX_CURVE_NONE = 0,
+    CX_CURVE_Ed25519 = 0x41
+} cx_curve_t;
+
+typedef enum {
+    CX_NONE = 0,
+    CX_SHA512 = 5
+} cx_md_t;
+
+// W is 0x04 || x || y with both coordinates big-endian, as on the device
+struct cx_ecfp_256_public_key_s {
+    cx_curve_t curve;
+    size_t W_len;
+    unsigned char W[65];
+};
+
+// d is the 32-byte Ed25519 secret (the RFC 8032 private key)
+struct cx_ecfp_256_private_key_s {
+    cx_curve_t curve;
+    size_t d_len;
+    unsigned char d[32];
+};
+
+typedef struct cx_ecfp_256_public_key_s cx_ecfp_256_public_key_t;
+typedef struct cx_ecfp_256_private_key_s cx_ecfp_256_private_key_t;
+typedef struct cx_ecfp_256_public_key_s cx_ecfp_public_key_t;
+typedef struct cx_ecfp_256_private_key_s cx_ecfp_private_key_t;
+
+int cx_ecfp_init_private_key(
+    cx_curve_t curve,
+    const unsigned char* raw_key,
+    unsigned int key_len,
+    cx_ecfp_private_key_t* pvkey
+);
+
+int cx_ecfp_init_public_key(
+    cx_curve_t curve,
+    const unsigned char* raw_key,
+    unsigned int key_len,
+    cx_ecfp_public_key_t* key
+);
+
+int cx_ecfp_generate_pair(
+    cx_curve_t curve,
+    cx_ecfp_public_key_t* pubkey,
+    cx_ecfp_private_key_t* privkey,
+    int keepprivate
+);
+
+int cx_eddsa_sign(
+    const cx_ecfp_private_key_t* pvkey,
+    int mode,
+    cx_md_t hashID,
+    const unsigned char* hash,
+    unsigned int hash_len,
+    const unsigned char* ctx,
+    unsigned int ctx_len,
+    unsigned char* sig,
+    unsigned int sig_len,
+    unsigned int* info
+);
+
+#endif // LEDGER_HEDERA_HOST_CX_H
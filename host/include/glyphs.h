@@ -0,0 +1,14 @@
+#ifndef LEDGER_HEDERA_HOST_GLYPHS_H
+#define LEDGER_HEDERA_HOST_GLYPHS_H 1
+
+// Host stand-in for the glyphs generated from glyphs/ by the SDK
+
+#include "ux.h"
+
+extern const bagl_icon_details_t C_icon_back;
+extern const bagl_icon_details_t C_icon_dashboard;
+extern const bagl_icon_details_t C_icon_dashboard_x;
+extern const bagl_icon_details_t C_icon_crossmark;
+extern const bagl_icon_details_t C_icon_validate_14;
+
+#endif // LEDGER_HEDERA_HOST_GLYPHS_H
@@ -0,0 +1,147 @@
+#ifndef LEDGER_HEDERA_HOST_OS_H
+#define LEDGER_HEDERA_HOST_OS_H 1
+
+// Host stand-in for the BOLOS os.h: the exception model, APDU I/O flags and
+// the handful of OS calls the app makes, backed by host/bolos.c
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cx.h"
+
+#define UNUSED(x) (void)x
+
+// Code and data are not relocated on the host
+#define PIC(x) ((void*) (x))
+
+#define U2BE(buf, off) ((uint16_t) (((buf)[off] << 8) | (buf)[(off) + 1]))
+#define U4BE(buf, off) \
+    (((uint32_t) (buf)[off] << 24) | ((uint32_t) (buf)[(off) + 1] << 16) | \
+     ((uint32_t) (buf)[(off) + 2] << 8) | (uint32_t) (buf)[(off) + 3])
+#define U4LE(buf, off) \
+    ((uint32_t) (buf)[off] | ((uint32_t) (buf)[(off) + 1] << 8) | \
+     ((uint32_t) (buf)[(off) + 2] << 16) | ((uint32_t) (buf)[(off) + 3] << 24))
+
+// Exceptions, with the SDK's numbering
+typedef unsigned short exception_t;
+
+#define EXCEPTION 1
+#define INVALID_PARAMETER 2
+#define EXCEPTION_OVERFLOW 3
+#define EXCEPTION_SECURITY 4
+#define INVALID_STATE 9
+#define EXCEPTION_APPEXIT 12
+#define EXCEPTION_IO_OVERFLOW 13
+#define EXCEPTION_IO_RESET 16
+
+typedef struct try_context_s try_context_t;
+
+struct try_context_s {
+    jmp_buf jmp_buf;
+    try_context_t* previous;
+    exception_t ex;
+};
+
+try_context_t* try_context_get(void);
+try_context_t* try_context_set(try_context_t* context);
+void os_longjmp(unsigned int exception) __attribute__((noreturn));
+
+#define BEGIN_TRY_L(L) \
+    { \
+        try_context_t __try##L;
+
+#define TRY_L(L) \
+    __try##L.ex = setjmp(__try##L.jmp_buf); \
+    if (__try##L.ex == 0) { \
+        __try##L.previous = try_context_set(&__try##L);
+
+#define CATCH_L(L, x) \
+        goto __FINALLY##L; \
+    } else if (__try##L.ex == x) { \
+        __try##L.ex = 0; \
+        try_context_set(__try##L.previous);
+
+#define CATCH_OTHER_L(L, e) \
+        goto __FINALLY##L; \
+    } else { \
+        exception_t e; \
+        e = __try##L.ex; \
+        __try##L.ex = 0; \
+        try_context_set(__try##L.previous);
+
+#define CATCH_ALL_L(L) \
+        goto __FINALLY##L; \
+    } else { \
+        __try##L.ex = 0; \
+        try_context_set(__try##L.previous);
+
+#define FINALLY_L(L) \
+        goto __FINALLY##L; \
+    } \
+    __FINALLY##L: \
+    if (try_context_get() == &__try##L) { \
+        try_context_set(__try##L.previous); \
+    }
+
+#define END_TRY_L(L) \
+        if (__try##L.ex != 0) { \
+            THROW_L(L, __try##L.ex); \
+        } \
+    }
+
+#define THROW_L(L, x) os_longjmp(x)
+
+#define BEGIN_TRY BEGIN_TRY_L(_)
+#define TRY TRY_L(_)
+#define CATCH(x) CATCH_L(_, x)
+#define CATCH_OTHER(e) CATCH_OTHER_L(_, e)
+#define CATCH_ALL CATCH_ALL_L(_)
+#define FINALLY FINALLY_L(_)
+#define END_TRY END_TRY_L(_)
+#define THROW(x) THROW_L(_, x)
+
+// APDU I/O
+#define IO_APDU_BUFFER_SIZE (5 + 255)
+
+#define CHANNEL_APDU 0
+#define CHANNEL_KEYBOARD 1
+#define CHANNEL_SPI 2
+
+#define IO_RESET_AFTER_REPLIED 0x80
+#define IO_RECEIVE_DATA 0x40
+#define IO_RETURN_AFTER_TX 0x20
+#define IO_ASYNCH_REPLY 0x10
+#define IO_FLAGS 0xF0
+
+extern unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+unsigned short io_exchange(unsigned char channel, unsigned short tx_len);
+
+// OS
+void os_boot(void);
+void os_sched_exit(unsigned int exit_code) __attribute__((noreturn));
+void reset(void);
+unsigned int os_global_pin_is_validated(void);
+
+#define OS_SETTING_PLANEMODE 6
+unsigned int os_setting_get(unsigned int setting_id, unsigned char* value, unsigned int maxlen);
+
+// Key derivation, from the host seed (see host_set_seed)
+#define HDW_NORMAL 0
+#define HDW_ED25519_SLIP10 1
+
+void os_perso_derive_node_bip32_seed_key(
+    unsigned int mode,
+    cx_curve_t curve,
+    const unsigned int* path,
+    unsigned int path_length,
+    unsigned char* private_key,
+    unsigned char* chain,
+    unsigned char* seed_key,
+    unsigned int seed_key_length
+);
+
+#endif // LEDGER_HEDERA_HOST_OS_H
@@ -0,0 +1,45 @@
+#ifndef LEDGER_HEDERA_HOST_OS_IO_SEPROXYHAL_H
+#define LEDGER_HEDERA_HOST_OS_IO_SEPROXYHAL_H 1
+
+// Host stand-in for the SEPROXYHAL transport. There is no secure element
+// link on the host: APDUs go through io_exchange in host/bolos.c, and the
+// only packets src/io.c sees are the ticker events the host injects.
+
+#include "os.h"
+#include "ux.h"
+
+#define SEPROXYHAL_TAG_BUTTON_PUSH_EVENT 0x05
+#define SEPROXYHAL_TAG_FINGER_EVENT 0x0C
+#define SEPROXYHAL_TAG_DISPLAY_PROCESSED_EVENT 0x0D
+#define SEPROXYHAL_TAG_TICKER_EVENT 0x0E
+#define SEPROXYHAL_TAG_STATUS_EVENT 0x15
+
+#define SEPROXYHAL_TAG_STATUS_EVENT_FLAG_USB_POWERED 0x00000008
+
+// A held button repeats every 100 ms; from the 8th repeat, every 3rd is
+// flagged BUTTON_EVT_FAST
+#define BUTTON_FAST_THRESHOLD_CS 8
+#define BUTTON_FAST_ACTION_CS 3
+
+#define IO_APDU_MEDIA_NONE 0
+#define IO_APDU_MEDIA_USB_HID 1
+
+// Defined by the app (src/io.c)
+extern unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
+
+extern unsigned int G_io_apdu_media;
+
+void io_seproxyhal_init(void);
+void io_seproxyhal_general_status(void);
+unsigned int io_seproxyhal_spi_is_status_sent(void);
+void io_seproxyhal_spi_send(const unsigned char* buffer, unsigned short length);
+unsigned short io_seproxyhal_spi_recv(unsigned char* buffer, unsigned short maxlength, unsigned int flags);
+void io_seproxyhal_display_default(bagl_element_t* element);
+
+// Defined by the app (src/io.c)
+unsigned char io_event(unsigned char channel);
+void io_seproxyhal_display(const bagl_element_t* element);
+
+void USB_power(unsigned char enabled);
+
+#endif // LEDGER_HEDERA_HOST_OS_IO_SEPROXYHAL_H
@@ -0,0 +1,121 @@
+#ifndef LEDGER_HEDERA_HOST_UX_H
+#define LEDGER_HEDERA_HOST_UX_H 1
+
+// Host stand-in for the Nano S BAGL UX layer. Screens are "drawn" by
+// sending each element to io_seproxyhal_display, as on the device, and
+// host/bolos.c keeps the resulting text so a driver can read the screen
+// and press buttons.
+
+#include "os.h"
+
+#define BAGL_NONE 0
+#define BAGL_RECTANGLE 3
+#define BAGL_ICON 5
+#define BAGL_LABELINE 7
+
+#define BAGL_FILL 1
+
+#define BAGL_FONT_OPEN_SANS_REGULAR_11px 10
+#define BAGL_FONT_ALIGNMENT_CENTER 0x8000
+
+#define BAGL_GLYPH_ICON_CHECK 6
+#define BAGL_GLYPH_ICON_CROSS 7
+#define BAGL_GLYPH_ICON_LEFT 9
+#define BAGL_GLYPH_ICON_RIGHT 10
+
+#define BUTTON_LEFT 1
+#define BUTTON_RIGHT 2
+#define BUTTON_EVT_FAST 0x40000000
+#define BUTTON_EVT_RELEASED 0x80000000
+
+typedef struct {
+    unsigned int type;
+    unsigned char userid;
+    short x;
+    short y;
+    unsigned short width;
+    unsigned short height;
+    unsigned char stroke;
+    unsigned char radius;
+    unsigned char fill;
+    unsigned int fgcolor;
+    unsigned int bgcolor;
+    unsigned short font_id;
+    unsigned char icon_id;
+} bagl_component_t;
+
+typedef struct bagl_element_e {
+    bagl_component_t component;
+    const char* text;
+} bagl_element_t;
+
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    unsigned int bpp;
+    const unsigned int* colors;
+    const unsigned char* bitmap;
+} bagl_icon_details_t;
+
+typedef const bagl_element_t* (*bagl_element_callback_t)(const bagl_element_t* element);
+typedef unsigned int (*button_push_callback_t)(unsigned int button_mask, unsigned int button_mask_counter);
+
+typedef struct ux_menu_entry_s ux_menu_entry_t;
+
+struct ux_menu_entry_s {
+    const ux_menu_entry_t* menu;
+    void (*callback)(unsigned int userid);
+    unsigned int userid;
+    const bagl_icon_details_t* icon;
+    const char* line1;
+    const char* line2;
+    char text_x;
+    char icon_x;
+};
+
+#define UX_MENU_END { NULL, NULL, 0, NULL, NULL, NULL, 0, 0 }
+
+typedef struct {
+    const bagl_element_t* elements;
+    unsigned int elements_count;
+    bagl_element_callback_t elements_preprocessor;
+    button_push_callback_t button_push_handler;
+    const ux_menu_entry_t* menu_entries;
+} ux_state_t;
+
+// Defined by the app (src/ui.c)
+extern ux_state_t ux;
+
+void host_ux_display(
+    const bagl_element_t* elements,
+    unsigned int count,
+    bagl_element_callback_t preprocessor,
+    button_push_callback_t button
+);
+void host_ux_redisplay(unsigned int index);
+void host_ux_menu_display(const ux_menu_entry_t* menu);
+
+#define UX_INIT() memset(&ux, 0, sizeof(ux))
+
+#define UX_DISPLAY(elements_array, preprocessor) \
+    host_ux_display( \
+        elements_array, \
+        sizeof(elements_array) / sizeof(elements_array[0]), \
+        preprocessor, \
+        elements_array##_button \
+    )
+
+#define UX_REDISPLAY() host_ux_redisplay(0)
+#define UX_REDISPLAY_IDX(index) host_ux_redisplay(index)
+
+#define UX_MENU_DISPLAY(current_entry, menu, display_preprocessor) \
+    host_ux_menu_display(menu)
+
+// Events are injected by the host directly, not through SEPROXYHAL packets
+#define UX_FINGER_EVENT(seph_packet)
+#define UX_BUTTON_PUSH_EVENT(seph_packet)
+#define UX_DISPLAYED_EVENT(...)
+#define UX_TICKER_EVENT(seph_packet, ...)
+#define UX_DEFAULT_EVENT()
+
+#endif // LEDGER_HEDERA_HOST_UX_H
@@ -0,0 +1,754 @@
+#include <dirent.h>
+#include <errno.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "histogram.h"
+#include "session.h"
+
+// Load generator for virtual devices (hedera_device): one client thread per
+// device, each running a weighted mix of workloads, with latency and the
+// status word mix reported per INS.
+//
+//     hedera_load [options] [-- device options]
+//
+//     -n devices     devices to start, one per core by default
+//     -a address     use a running device instead, host:port or a Unix
+//                    socket path; repeatable
+//     -t seconds     length of the run (10)
+//     -m mix         weights of the workloads (silent=60,sign=30,malformed=10)
+//     -b burst       sign requests written back to back per signing burst (8)
+//     -c corpus      transaction bodies (make -C host corpus)
+//     -D path        hedera_device to start (next to this program)
+//
+// Workloads:
+//
+//     config     GET_APP_CONFIGURATION
+//     silent     GET_PUBLIC_KEY with P1 = 1, for a random key index
+//     sign       a burst of SIGN_TRANSACTION over the valid corpus bodies,
+//                all written before the first response is read
+//     malformed  a malformed corpus body, short sign data, a bad CLA or an
+//                unknown INS
+//
+// Started devices get the device options, "-p approve" if none are given.
+// Latency runs from a request being written to its response being read,
+// so a burst's later requests include their wait behind the earlier ones.
+
+#define MAX_DEVICES 256
+#define MAX_BODIES 256
+#define MAX_BURST 64
+#define MAX_STATUS 8
+
+// Status words kept apart from "transport", for a response that never came
+#define SW_TRANSPORT 0
+
+enum Workload {
+    WORKLOAD_CONFIG,
+    WORKLOAD_SILENT,
+    WORKLOAD_SIGN,
+    WORKLOAD_MALFORMED,
+    WORKLOAD_COUNT
+};
+
+static const char* const WORKLOAD_NAMES[WORKLOAD_COUNT] = {
+    [WORKLOAD_CONFIG] = "config",
+    [WORKLOAD_SILENT] = "silent",
+    [WORKLOAD_SIGN] = "sign",
+    [WORKLOAD_MALFORMED] = "malformed",
+};
+
+struct body_t {
+    uint8_t data[SESSION_APDU_SIZE];
+    size_t length;
+};
+
+struct status_t {
+    uint16_t sw;
+    uint64_t count;
+};
+
+// What one INS saw on one client
+struct ins_stats_t {
+    struct histogram_t latency;
+    struct status_t status[MAX_STATUS];
+    size_t status_count;
+};
+
+struct client_t {
+    pthread_t thread;
+    const char* address;
+    int fd;
+    unsigned int seed;
+    struct ins_stats_t* ins[256];
+};
+
+struct request_t {
+    uint8_t apdu[SESSION_APDU_SIZE];
+    size_t length;
+    uint64_t sent;
+};
+
+static struct body_t valid_bodies[MAX_BODIES];
+static size_t valid_count;
+static struct body_t malformed_bodies[MAX_BODIES];
+static size_t malformed_count;
+
+static unsigned int weights[WORKLOAD_COUNT] = {
+    [WORKLOAD_SILENT] = 60,
+    [WORKLOAD_SIGN] = 30,
+    [WORKLOAD_MALFORMED] = 10,
+};
+static unsigned int weight_total;
+static unsigned int burst = 8;
+static uint64_t deadline;
+
+static struct client_t clients[MAX_DEVICES];
+static size_t client_count;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Transaction bodies from the corpus directory, by file name: malformed-*
+// to one list, everything else to the other
+static bool load_corpus(const char* directory) {
+    struct dirent* entry;
+    DIR* dir = opendir(directory);
+
+    if (!dir) {
+        perror(directory);
+        return false;
+    }
+
+    while ((entry = readdir(dir))) {
+        bool malformed = strncmp(entry->d_name, "malformed-", 10) == 0;
+        struct body_t* body = malformed
+            ? &malformed_bodies[malformed_count]
+            : &valid_bodies[valid_count];
+        char path[1024];
+        FILE* file;
+
+        if (!strstr(entry->d_name, ".bin") ||
+            (malformed ? malformed_count : valid_count) == MAX_BODIES) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        file = fopen(path, "rb");
+        if (!file) {
+            continue;
+        }
+
+        body->length = fread(body->data, 1, sizeof(body->data), file);
+        fclose(file);
+
+        // Key index and body must fit the one-byte Lc
+        if (body->length + 4 > 255) {
+            continue;
+        }
+
+        if (malformed) {
+            malformed_count++;
+        } else {
+            valid_count++;
+        }
+    }
+
+    closedir(dir);
+
+    if (valid_count == 0) {
+        fprintf(stderr, "no transaction bodies in %s\n", directory);
+        return false;
+    }
+
+    return true;
+}
+
+static bool parse_mix(const char* text) {
+    char copy[256];
+    char* saved;
+
+    memset(weights, 0, sizeof(weights));
+    snprintf(copy, sizeof(copy), "%s", text);
+
+    for (char* item = strtok_r(copy, ",", &saved); item; item = strtok_r(NULL, ",", &saved)) {
+        char* equals = strchr(item, '=');
+        size_t i;
+
+        if (!equals) {
+            return false;
+        }
+        *equals = '\0';
+
+        for (i = 0; i < WORKLOAD_COUNT; i++) {
+            if (strcmp(item, WORKLOAD_NAMES[i]) == 0) {
+                break;
+            }
+        }
+        if (i == WORKLOAD_COUNT) {
+            return false;
+        }
+
+        weights[i] = strtoul(equals + 1, NULL, 10);
+    }
+
+    return true;
+}
+
+static int connect_to(const char* address) {
+    const char* colon = strrchr(address, ':');
+    int fd = -1;
+
+    if (colon && !strchr(address, '/')) {
+        char host[256];
+        struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+        struct addrinfo* info;
+
+        snprintf(host, sizeof(host), "%.*s", (int) (colon - address), address);
+        if (getaddrinfo(host, colon + 1, &hints, &info) != 0) {
+            return -1;
+        }
+
+        fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+        if (fd >= 0 && connect(fd, info->ai_addr, info->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+
+        freeaddrinfo(info);
+    } else {
+        struct sockaddr_un un = { .sun_family = AF_UNIX };
+
+        snprintf(un.sun_path, sizeof(un.sun_path), "%s", address);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr*) &un, sizeof(un)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    return fd;
+}
+
+static bool write_all(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = write(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+static bool read_all(int fd, uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = read(fd, data, length);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+// Reads one response and returns its status word, or SW_TRANSPORT
+static uint16_t read_response(int fd) {
+    uint8_t data[4 + SESSION_APDU_SIZE];
+    uint32_t length;
+
+    if (!read_all(fd, data, 4)) {
+        return SW_TRANSPORT;
+    }
+
+    length = (uint32_t) data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3];
+    if (length > SESSION_APDU_SIZE - 2 || !read_all(fd, data, length + 2)) {
+        return SW_TRANSPORT;
+    }
+
+    return data[length] << 8 | data[length + 1];
+}
+
+static void record(struct client_t* client, uint8_t ins, uint16_t sw, uint64_t latency) {
+    struct ins_stats_t* stats = client->ins[ins];
+    size_t i;
+
+    if (!stats) {
+        stats = client->ins[ins] = calloc(1, sizeof(*stats));
+    }
+
+    if (sw != SW_TRANSPORT) {
+        histogram_add(&stats->latency, latency);
+    }
+
+    for (i = 0; i < stats->status_count; i++) {
+        if (stats->status[i].sw == sw) {
+            break;
+        }
+    }
+
+    if (i == stats->status_count) {
+        if (i == MAX_STATUS) {
+            // Lump rare status words in with the last one kept
+            i--;
+        } else {
+            stats->status[stats->status_count++].sw = sw;
+        }
+    }
+
+    stats->status[i].count++;
+}
+
+static void build_apdu(
+    struct request_t* request,
+    uint8_t cla,
+    uint8_t ins,
+    uint8_t p1,
+    const uint8_t* data,
+    size_t length
+) {
+    request->apdu[0] = cla;
+    request->apdu[1] = ins;
+    request->apdu[2] = p1;
+    request->apdu[3] = 0;
+    request->apdu[4] = length;
+    memmove(request->apdu + 5, data, length);
+    request->length = 5 + length;
+}
+
+static void build_sign(struct request_t* request, uint32_t key_index, const struct body_t* body) {
+    uint8_t data[4 + SESSION_APDU_SIZE];
+
+    data[0] = key_index;
+    data[1] = key_index >> 8;
+    data[2] = key_index >> 16;
+    data[3] = key_index >> 24;
+    memmove(data + 4, body->data, body->length);
+
+    build_apdu(request, 0xE0, 0x04, 0, data, 4 + body->length);
+}
+
+// Requests of one pick of a workload; returns their number
+static size_t build_workload(struct client_t* client, struct request_t* requests) {
+    unsigned int pick = rand_r(&client->seed) % weight_total;
+    uint32_t key_index = rand_r(&client->seed) % 16;
+    uint8_t key[4] = { key_index, 0, 0, 0 };
+    enum Workload workload = 0;
+
+    while (pick >= weights[workload]) {
+        pick -= weights[workload++];
+    }
+
+    switch (workload) {
+        case WORKLOAD_CONFIG:
+            build_apdu(&requests[0], 0xE0, 0x01, 0, NULL, 0);
+            return 1;
+
+        case WORKLOAD_SILENT:
+            build_apdu(&requests[0], 0xE0, 0x02, 1, key, sizeof(key));
+            return 1;
+
+        case WORKLOAD_SIGN:
+            for (size_t i = 0; i < burst; i++) {
+                build_sign(&requests[i], key_index, &valid_bodies[rand_r(&client->seed) % valid_count]);
+            }
+            return burst;
+
+        default:
+            switch (rand_r(&client->seed) % 4) {
+                case 0:
+                    if (malformed_count > 0) {
+                        build_sign(&requests[0], key_index, &malformed_bodies[rand_r(&client->seed) % malformed_count]);
+                        break;
+                    }
+                    // fall through
+                case 1:
+                    build_apdu(&requests[0], 0xE0, 0x04, 0, key, 2);
+                    break;
+                case 2:
+                    build_apdu(&requests[0], 0xB0, 0x01, 0, NULL, 0);
+                    break;
+                default:
+                    build_apdu(&requests[0], 0xE0, 0x7F, 0, NULL, 0);
+                    break;
+            }
+            return 1;
+    }
+}
+
+static void* run_client(void* argument) {
+    struct client_t* client = argument;
+    static __thread struct request_t requests[MAX_BURST];
+
+    while (now_ns() < deadline) {
+        size_t count;
+        size_t answered = 0;
+
+        if (client->fd < 0) {
+            client->fd = connect_to(client->address);
+            if (client->fd < 0) {
+                fprintf(stderr, "%s: cannot connect\n", client->address);
+                return NULL;
+            }
+        }
+
+        count = build_workload(client, requests);
+
+        for (size_t i = 0; i < count; i++) {
+            uint8_t frame[4 + SESSION_APDU_SIZE];
+            size_t length = requests[i].length;
+
+            frame[0] = 0;
+            frame[1] = 0;
+            frame[2] = length >> 8;
+            frame[3] = length;
+            memmove(frame + 4, requests[i].apdu, length);
+
+            requests[i].sent = now_ns();
+            if (!write_all(client->fd, frame, 4 + length)) {
+                count = i;
+                break;
+            }
+        }
+
+        for (; answered < count; answered++) {
+            uint16_t sw = read_response(client->fd);
+
+            record(client, requests[answered].apdu[1], sw, now_ns() - requests[answered].sent);
+
+            if (sw == SW_TRANSPORT) {
+                break;
+            }
+        }
+
+        // The device dropped us: count what went unanswered and reconnect
+        if (answered < count) {
+            for (answered++; answered < count; answered++) {
+                record(client, requests[answered].apdu[1], SW_TRANSPORT, 0);
+            }
+
+            close(client->fd);
+            client->fd = -1;
+        }
+    }
+
+    return NULL;
+}
+
+static pid_t start_device(const char* program, char** options, int option_count, const char* path) {
+    static char* approve[] = { "-p", "approve" };
+    char** argv;
+    int argc = 0;
+    pid_t pid;
+
+    if (option_count == 0) {
+        options = approve;
+        option_count = 2;
+    }
+
+    argv = calloc(option_count + 4, sizeof(char*));
+    argv[argc++] = (char*) program;
+    for (int i = 0; i < option_count; i++) {
+        argv[argc++] = options[i];
+    }
+    argv[argc++] = "-u";
+    argv[argc++] = (char*) path;
+    argv[argc] = NULL;
+
+    pid = fork();
+    if (pid == 0) {
+        execv(program, argv);
+        perror(program);
+        _exit(127);
+    }
+
+    free(argv);
+
+    return pid;
+}
+
+// Waits for a started device to accept; its client thread connects again
+static bool wait_for_device(const char* path) {
+    for (int attempt = 0; attempt < 500; attempt++) {
+        int fd = connect_to(path);
+
+        if (fd >= 0) {
+            close(fd);
+            return true;
+        }
+
+        usleep(10000);
+    }
+
+    fprintf(stderr, "%s: device did not start\n", path);
+    return false;
+}
+
+static void print_report(double seconds) {
+    uint64_t total = 0;
+
+    printf(
+        "%-4s %10s %10s %10s %10s %10s %10s  %s\n",
+        "INS", "commands", "per s", "p50 us", "p99 us", "p99.9 us", "max us", "status"
+    );
+
+    for (int ins = 0; ins < 256; ins++) {
+        struct ins_stats_t merged;
+        uint64_t commands = 0;
+        bool seen = false;
+
+        memset(&merged, 0, sizeof(merged));
+
+        for (size_t c = 0; c < client_count; c++) {
+            const struct ins_stats_t* stats = clients[c].ins[ins];
+
+            if (!stats) {
+                continue;
+            }
+            seen = true;
+
+            histogram_merge(&merged.latency, &stats->latency);
+
+            for (size_t s = 0; s < stats->status_count; s++) {
+                size_t i;
+
+                for (i = 0; i < merged.status_count; i++) {
+                    if (merged.status[i].sw == stats->status[s].sw) {
+                        break;
+                    }
+                }
+                if (i == merged.status_count) {
+                    if (i == MAX_STATUS) {
+                        i--;
+                    } else {
+                        merged.status[merged.status_count++].sw = stats->status[s].sw;
+                    }
+                }
+
+                merged.status[i].count += stats->status[s].count;
+            }
+        }
+
+        if (!seen) {
+            continue;
+        }
+
+        for (size_t i = 0; i < merged.status_count; i++) {
+            commands += merged.status[i].count;
+        }
+        total += commands;
+
+        printf(
+            "%02x   %10llu %10.0f %10.1f %10.1f %10.1f %10.1f ",
+            ins,
+            (unsigned long long) commands,
+            commands / seconds,
+            histogram_percentile(&merged.latency, 50) / 1e3,
+            histogram_percentile(&merged.latency, 99) / 1e3,
+            histogram_percentile(&merged.latency, 99.9) / 1e3,
+            merged.latency.max / 1e3
+        );
+
+        for (size_t i = 0; i < merged.status_count; i++) {
+            if (merged.status[i].sw == SW_TRANSPORT) {
+                printf(" transport");
+            } else {
+                printf(" %04x", merged.status[i].sw);
+            }
+            printf(" %.1f%%", 100.0 * merged.status[i].count / commands);
+        }
+        printf("\n");
+    }
+
+    printf(
+        "\n%zu devices, %llu commands in %.1f s, %.0f commands/s\n",
+        client_count,
+        (unsigned long long) total,
+        seconds,
+        total / seconds
+    );
+}
+
+static void usage() {
+    fprintf(
+        stderr,
+        "usage: hedera_load [-n devices | -a address...] [-t seconds] [-m mix] [-b burst]\n"
+        "                   [-c corpus] [-D hedera_device] [-- device options]\n"
+    );
+    exit(2);
+}
+
+int main(int argc, char* argv[]) {
+    static char addresses[MAX_DEVICES][108];
+    static pid_t devices[MAX_DEVICES];
+    char device_program[1024];
+    char directory[] = "/tmp/hedera_load.XXXXXX";
+    const char* corpus = "build/corpus";
+    long device_count = sysconf(_SC_NPROCESSORS_ONLN);
+    double seconds = 10;
+    size_t started = 0;
+    uint64_t elapsed;
+    int arg;
+
+    // The device is built next to this program
+    snprintf(device_program, sizeof(device_program), "%s", argv[0]);
+    if (strrchr(device_program, '/')) {
+        strcpy(strrchr(device_program, '/') + 1, "hedera_device");
+    } else {
+        strcpy(device_program, "hedera_device");
+    }
+
+    for (arg = 1; arg < argc && argv[arg][0] == '-'; arg += 2) {
+        if (strcmp(argv[arg], "--") == 0) {
+            break;
+        }
+        if (arg + 1 == argc) {
+            usage();
+        }
+
+        switch (argv[arg][1]) {
+            case 'n':
+                device_count = strtol(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'a':
+                if (client_count == MAX_DEVICES) {
+                    usage();
+                }
+                clients[client_count++].address = argv[arg + 1];
+                break;
+
+            case 't':
+                seconds = strtod(argv[arg + 1], NULL);
+                break;
+
+            case 'm':
+                if (!parse_mix(argv[arg + 1])) {
+                    usage();
+                }
+                break;
+
+            case 'b':
+                burst = strtoul(argv[arg + 1], NULL, 10);
+                break;
+
+            case 'c':
+                corpus = argv[arg + 1];
+                break;
+
+            case 'D':
+                snprintf(device_program, sizeof(device_program), "%s", argv[arg + 1]);
+                break;
+
+            default:
+                usage();
+        }
+    }
+
+    if (arg < argc && strcmp(argv[arg], "--") != 0) {
+        usage();
+    }
+    if (arg < argc) {
+        arg++;
+    }
+
+    for (size_t i = 0; i < WORKLOAD_COUNT; i++) {
+        weight_total += weights[i];
+    }
+
+    if (weight_total == 0 || burst == 0 || burst > MAX_BURST ||
+        device_count < 1 || device_count > MAX_DEVICES || seconds <= 0) {
+        usage();
+    }
+
+    if (!load_corpus(corpus)) {
+        return 2;
+    }
+
+    if (client_count == 0) {
+        if (!mkdtemp(directory)) {
+            perror(directory);
+            return 2;
+        }
+
+        for (; started < (size_t) device_count; started++) {
+            snprintf(addresses[started], sizeof(addresses[0]), "%s/device-%zu.sock", directory, started);
+            devices[started] = start_device(device_program, argv + arg, argc - arg, addresses[started]);
+            clients[started].address = addresses[started];
+        }
+
+        client_count = started;
+
+        for (size_t i = 0; i < started; i++) {
+            if (!wait_for_device(addresses[i])) {
+                client_count = 0;
+                break;
+            }
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    elapsed = now_ns();
+    deadline = elapsed + (uint64_t) (seconds * 1e9);
+
+    for (size_t i = 0; i < client_count; i++) {
+        clients[i].fd = -1;
+        clients[i].seed = i + 1;
+        pthread_create(&clients[i].thread, NULL, run_client, &clients[i]);
+    }
+
+    for (size_t i = 0; i < client_count; i++) {
+        pthread_join(clients[i].thread, NULL);
+        if (clients[i].fd >= 0) {
+            close(clients[i].fd);
+        }
+    }
+
+    elapsed = now_ns() - elapsed;
+
+    for (size_t i = 0; i < started; i++) {
+        kill(devices[i], SIGTERM);
+        waitpid(devices[i], NULL, 0);
+        unlink(addresses[i]);
+    }
+    if (started > 0) {
+        rmdir(directory);
+    }
+
+    if (client_count == 0) {
+        return 1;
+    }
+
+    print_report(elapsed / 1e9);
+
+    return 0;
+}
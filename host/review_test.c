@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <ux.h>
+
+#include "host.h"
+#include "session.h"
+
+// Button handling of the Nano S review: holds that repeat fast, and the
+// presses that follow them. Each case signs the transfer of
+// sessions/sign_transfer.apdus with a script of buttons, checks the screen
+// before each press, and expects the signature once Confirm is pressed.
+//
+//     make -C host test
+
+struct press_t {
+    char button;          // as in a session's buttons line
+    const char* screen;   // start of the screen it is pressed on
+};
+
+struct case_t {
+    const char* name;
+    struct press_t presses[16];
+};
+
+static const struct case_t CASES[] = {
+    {
+        // A fast hold moves a field per repeat and stops before Confirm;
+        // the next deliberate press must not be swallowed
+        "hold, release, press",
+        {
+            { 'R', "Transfer" },
+            { 'r', "Operator" },
+            { 'R', "Memo" },
+            { 'B', "Confirm" },
+        },
+    },
+    {
+        "hold back, press",
+        {
+            { 'R', "Transfer" },
+            { 'r', "Operator" },
+            { 'l', "Memo" },
+            { 'R', "Operator" },
+            { 'R', "Sender" },
+            { 'B', "Recipient" },
+            { 'B', "Confirm" },
+        },
+    },
+    {
+        "plain presses",
+        {
+            { 'R', "Transfer" },
+            { 'R', "Operator" },
+            { 'L', "Sender" },
+            { 'B', "Operator" },
+            { 'B', "Confirm" },
+        },
+    },
+};
+
+static const char TRANSFER[] =
+    "e0 04 00 00 41 00000000 0a0812060800100018021880c2d72f320a68656c6c6f20686f737472"
+    "200a1e0a0d0a0608001000180210ff83af5f0a0d0a06080010001803108084af5f";
+
+struct run_t {
+    const struct case_t* test;
+    size_t press;
+    bool sent;
+    bool failed;
+    uint16_t sw;
+    size_t response_length;
+};
+
+static size_t next_apdu(void* user, uint8_t* apdu, size_t size) {
+    struct run_t* run = user;
+
+    if (run->sent) {
+        return 0;
+    }
+
+    run->sent = true;
+
+    return session_parse_hex(TRANSFER, apdu, size);
+}
+
+static void response(void* user, const uint8_t* apdu, size_t length) {
+    struct run_t* run = user;
+
+    run->sw = apdu[length - 2] << 8 | apdu[length - 1];
+    run->response_length = length;
+}
+
+static unsigned int next_button(void* user) {
+    struct run_t* run = user;
+    const struct press_t* press = &run->test->presses[run->press];
+    const char* screen = host_screen();
+
+    if (press->button == '\0') {
+        fprintf(stderr, "%s: out of buttons on [%s]\n", run->test->name, screen);
+        run->failed = true;
+        return 0;
+    }
+
+    if (strncmp(screen, press->screen, strlen(press->screen)) != 0) {
+        fprintf(
+            stderr,
+            "%s: press %zu expected [%s...], found [%s]\n",
+            run->test->name,
+            run->press + 1,
+            press->screen,
+            screen
+        );
+        run->failed = true;
+        return 0;
+    }
+
+    run->press++;
+
+    return session_button_mask(press->button);
+}
+
+int main() {
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        struct run_t run = { .test = &CASES[i] };
+        struct host_io_t io = {
+            .next_apdu = next_apdu,
+            .response = response,
+            .next_button = next_button,
+            .user = &run,
+        };
+
+        host_run(&io);
+
+        if (!run.failed && (run.sw != 0x9000 || run.response_length != 64 + 2)) {
+            fprintf(stderr, "%s: status %04x, %zu bytes\n", CASES[i].name, run.sw, run.response_length);
+            run.failed = true;
+        }
+
+        printf("%-24s %s\n", CASES[i].name, run.failed ? "FAIL" : "ok");
+        failures += run.failed;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ux.h>
+
+#include "session.h"
+
+#define LINE_SIZE 1024
+
+size_t session_parse_hex(const char* text, uint8_t* dst, size_t size) {
+    size_t length = 0;
+    int high = -1;
+
+    for (; *text; text++) {
+        int nibble;
+
+        if (isspace((unsigned char) *text)) {
+            continue;
+        }
+        if (!isxdigit((unsigned char) *text) || length == size) {
+            return 0;
+        }
+
+        nibble = isdigit((unsigned char) *text)
+            ? *text - '0'
+            : tolower((unsigned char) *text) - 'a' + 10;
+
+        if (high < 0) {
+            high = nibble;
+        } else {
+            dst[length++] = (high << 4) | nibble;
+            high = -1;
+        }
+    }
+
+    return high < 0 ? length : 0;
+}
+
+int session_parse_buttons(const char* text, char* dst, size_t size) {
+    size_t count = 0;
+
+    while (isspace((unsigned char) *text)) {
+        text++;
+    }
+    if (strncmp(text, "buttons", 7) != 0) {
+        return -1;
+    }
+
+    for (text += 7; *text && count < size; text++) {
+        if (strchr("LRBlr", *text)) {
+            dst[count++] = *text;
+        }
+    }
+
+    return count;
+}
+
+unsigned int session_button_mask(char button) {
+    switch (button) {
+        case 'L':
+            return BUTTON_LEFT;
+
+        case 'R':
+            return BUTTON_RIGHT;
+
+        case 'l':
+            return BUTTON_EVT_FAST | BUTTON_LEFT;
+
+        case 'r':
+            return BUTTON_EVT_FAST | BUTTON_RIGHT;
+
+        default:
+            return BUTTON_LEFT | BUTTON_RIGHT;
+    }
+}
+
+bool session_load(struct session_t* session, const char* path) {
+    char line[LINE_SIZE];
+    char buttons[SESSION_BUTTONS_SIZE];
+    int button_count = 0;
+    const char* base = strrchr(path, '/');
+    char* extension;
+    size_t capacity = 0;
+    FILE* file;
+
+    memset(session, 0, sizeof(*session));
+
+    base = base ? base + 1 : path;
+    snprintf(session->name, sizeof(session->name), "%s", base);
+    extension = strrchr(session->name, '.');
+    if (extension) {
+        *extension = '\0';
+    }
+
+    file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        struct session_step_t* step;
+        char* text = line;
+        int count;
+
+        while (isspace((unsigned char) *text)) {
+            text++;
+        }
+        if (*text == '\0' || *text == '#') {
+            continue;
+        }
+
+        count = session_parse_buttons(text, buttons, sizeof(buttons));
+        if (count >= 0) {
+            button_count = count;
+            continue;
+        }
+
+        if (session->count == capacity) {
+            capacity = capacity ? 2 * capacity : 8;
+            session->steps = realloc(session->steps, capacity * sizeof(*step));
+        }
+
+        step = &session->steps[session->count];
+        step->length = session_parse_hex(text, step->apdu, sizeof(step->apdu));
+        if (step->length == 0) {
+            fprintf(stderr, "%s: bad APDU: %s", path, line);
+            fclose(file);
+            session_free(session);
+            return false;
+        }
+
+        // A script applies to the next APDU only
+        memmove(step->buttons, buttons, button_count);
+        step->button_count = button_count;
+        button_count = 0;
+
+        session->count++;
+    }
+
+    fclose(file);
+
+    return true;
+}
+
+void session_free(struct session_t* session) {
+    free(session->steps);
+    session->steps = NULL;
+    session->count = 0;
+}
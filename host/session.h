@@ -0,0 +1,50 @@
+#ifndef LEDGER_HEDERA_HOST_SESSION_H
+#define LEDGER_HEDERA_HOST_SESSION_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A recorded APDU session (host/sessions/*.apdus):
+//
+//     e0 02 00 00 04 00000000   request APDU in hex, spaces optional
+//     buttons RRRRRRB           presses for the next UI prompt: Left,
+//                               Right or Both, or l and r to hold Left or
+//                               Right until it repeats fast
+//     # comment
+
+#define SESSION_APDU_SIZE 260
+#define SESSION_BUTTONS_SIZE 64
+
+struct session_step_t {
+    uint8_t apdu[SESSION_APDU_SIZE];
+    size_t length;
+
+    // Presses for the prompt this APDU raises, if it raises one
+    char buttons[SESSION_BUTTONS_SIZE];
+    size_t button_count;
+};
+
+struct session_t {
+    char name[64];
+    struct session_step_t* steps;
+    size_t count;
+};
+
+// Parses a line of hex into dst; returns its length, or 0 if the line is
+// not hex or does not fit
+extern size_t session_parse_hex(const char* text, uint8_t* dst, size_t size);
+
+// Parses a "buttons" line into dst; returns the number of presses, or -1
+// if the line is not a button script
+extern int session_parse_buttons(const char* text, char* dst, size_t size);
+
+// Button mask of a press in a script
+extern unsigned int session_button_mask(char button);
+
+// Loads a session file, named after its base name; false on error
+extern bool session_load(struct session_t* session, const char* path);
+
+extern void session_free(struct session_t* session);
+
+#endif // LEDGER_HEDERA_HOST_SESSION_H
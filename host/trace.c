@@ -0,0 +1,125 @@
+#include <string.h>
+#include <time.h>
+
+#include "trace.h"
+
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void put_le(uint8_t* dst, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        dst[i] = value >> (8 * i);
+    }
+}
+
+static uint64_t get_le(const uint8_t* src, size_t size) {
+    uint64_t value = 0;
+
+    for (size_t i = size; i > 0; i--) {
+        value = value << 8 | src[i - 1];
+    }
+
+    return value;
+}
+
+bool trace_open(struct trace_writer_t* writer, const char* path) {
+    uint8_t header[TRACE_FILE_HEADER_SIZE] = { 0 };
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        return false;
+    }
+
+    writer->started = clock_ns(CLOCK_MONOTONIC);
+    memset(writer->command, 0, sizeof(writer->command));
+
+    memmove(header, TRACE_MAGIC, 8);
+    put_le(header + 8, TRACE_VERSION, 4);
+    put_le(header + 16, clock_ns(CLOCK_REALTIME), 8);
+
+    return fwrite(header, sizeof(header), 1, writer->file) == 1;
+}
+
+static void write_record(
+    struct trace_writer_t* writer,
+    enum TraceDirection direction,
+    uint16_t sw,
+    const uint8_t* payload,
+    size_t length
+) {
+    uint8_t header[TRACE_RECORD_HEADER_SIZE];
+
+    put_le(header, clock_ns(CLOCK_MONOTONIC) - writer->started, 8);
+    header[8] = direction;
+    memmove(header + 9, writer->command, 4);
+    put_le(header + 13, sw, 2);
+    put_le(header + 15, length, 2);
+    header[17] = 0;
+
+    fwrite(header, sizeof(header), 1, writer->file);
+    fwrite(payload, 1, length, writer->file);
+}
+
+void trace_command(struct trace_writer_t* writer, const uint8_t* apdu, size_t length) {
+    size_t data_length = 0;
+
+    if (length < 4) {
+        return;
+    }
+
+    memmove(writer->command, apdu, 4);
+
+    if (length > 5) {
+        data_length = length - 5;
+    }
+
+    write_record(writer, TRACE_COMMAND, 0, apdu + 5, data_length);
+}
+
+void trace_response(struct trace_writer_t* writer, const uint8_t* apdu, size_t length) {
+    if (length < 2) {
+        return;
+    }
+
+    write_record(
+        writer,
+        TRACE_RESPONSE,
+        apdu[length - 2] << 8 | apdu[length - 1],
+        apdu,
+        length - 2
+    );
+}
+
+void trace_close(struct trace_writer_t* writer) {
+    if (writer->file) {
+        fclose(writer->file);
+        writer->file = NULL;
+    }
+}
+
+size_t trace_parse(const uint8_t* data, size_t size, struct trace_record_t* record) {
+    if (size < TRACE_RECORD_HEADER_SIZE) {
+        return 0;
+    }
+
+    record->time = get_le(data, 8);
+    record->direction = data[8];
+    record->cla = data[9];
+    record->ins = data[10];
+    record->p1 = data[11];
+    record->p2 = data[12];
+    record->sw = get_le(data + 13, 2);
+    record->length = get_le(data + 15, 2);
+    record->payload = data + TRACE_RECORD_HEADER_SIZE;
+
+    if (size - TRACE_RECORD_HEADER_SIZE < record->length) {
+        return 0;
+    }
+
+    return TRACE_RECORD_HEADER_SIZE + record->length;
+}
@@ -0,0 +1,69 @@
+#ifndef LEDGER_HEDERA_HOST_TRACE_H
+#define LEDGER_HEDERA_HOST_TRACE_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// APDU traces, as recorded through trace_open by hedera_host -r and
+// hedera_device -r, and read by hedera_trace. All integers are
+// little-endian.
+//
+// File header, 24 bytes:
+//     magic "HEDTRACE" (8) | version (4) | reserved (4)
+//     wall clock at the start, ns since the Unix epoch (8)
+//
+// Then one record per APDU, an 18-byte header and the payload:
+//     time since the start, ns (8)
+//     direction (1): TRACE_COMMAND or TRACE_RESPONSE
+//     CLA, INS, P1, P2 (4), of the command a response answers
+//     status word (2), 0 for commands
+//     payload length (2) | reserved (1)
+//     payload: command data after Lc, or response data before the status
+
+#define TRACE_MAGIC "HEDTRACE"
+#define TRACE_VERSION 1
+
+#define TRACE_FILE_HEADER_SIZE 24
+#define TRACE_RECORD_HEADER_SIZE 18
+
+enum TraceDirection {
+    TRACE_COMMAND = 0,
+    TRACE_RESPONSE = 1
+};
+
+struct trace_record_t {
+    uint64_t time;
+    uint8_t direction;
+    uint8_t cla;
+    uint8_t ins;
+    uint8_t p1;
+    uint8_t p2;
+    uint16_t sw;
+    uint16_t length;
+    const uint8_t* payload;
+};
+
+struct trace_writer_t {
+    FILE* file;
+    uint64_t started;
+    uint8_t command[4];
+};
+
+// Creates the file and writes its header; false on error
+extern bool trace_open(struct trace_writer_t* writer, const char* path);
+
+// A full request APDU (CLA INS P1 P2 Lc data)
+extern void trace_command(struct trace_writer_t* writer, const uint8_t* apdu, size_t length);
+
+// A full response APDU (data SW1 SW2)
+extern void trace_response(struct trace_writer_t* writer, const uint8_t* apdu, size_t length);
+
+extern void trace_close(struct trace_writer_t* writer);
+
+// Parses the record at data into record; returns its total size, or 0 if
+// fewer than size bytes hold a whole record
+extern size_t trace_parse(const uint8_t* data, size_t size, struct trace_record_t* record);
+
+#endif // LEDGER_HEDERA_HOST_TRACE_H
@@ -0,0 +1,472 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <os.h>
+
+#include "context.h"
+#include "globals.h"
+#include "hedera.h"
+#include "histogram.h"
+#include "sign_transaction.h"
+#include "trace.h"
+
+// Reads an APDU trace (host/trace.h) and reports, for each INS, the latency
+// distribution from command to response, the status word mix and retries;
+// then the slowest signing commands, with their bodies decoded by the app's
+// own decoder.
+//
+//     hedera_trace [-s ms] [-n outliers] trace.bin
+//
+// A retry is a command identical to the last one with the same INS, sent
+// again after its response. Signing commands at or above -s ms are
+// outliers, the slowest -n (10) listed; without -s, the p99 of
+// SIGN_TRANSACTION is the threshold.
+//
+// The file is memory mapped and read front to back, so traces of many GB
+// need no more memory than the tables below.
+
+#define ctx (G_command_context.sign_transaction)
+
+#define INS_SIGN_TRANSACTION 0x04
+
+#define MAX_STATUS 8
+#define MAX_OUTLIERS 100
+
+// Latency bands of the distribution, in ns
+static const uint64_t BANDS[] = {
+    100000, 1000000, 10000000, 100000000, 1000000000, 10000000000ULL
+};
+static const char* const BAND_NAMES[] = {
+    "<0.1ms", "<1ms", "<10ms", "<100ms", "<1s", "<10s", ">=10s"
+};
+
+#define BAND_COUNT (sizeof(BAND_NAMES) / sizeof(BAND_NAMES[0]))
+
+struct status_t {
+    uint16_t sw;
+    uint64_t count;
+};
+
+struct ins_t {
+    struct histogram_t latency;
+    uint64_t bands[BAND_COUNT];
+    struct status_t status[MAX_STATUS];
+    size_t status_count;
+    uint64_t unanswered;
+
+    // The last command, pointing into the mapping
+    struct trace_record_t last;
+    uint16_t last_sw;
+    bool has_last;
+
+    uint64_t retries;
+    struct status_t retried_after[MAX_STATUS];
+    size_t retried_after_count;
+};
+
+struct outlier_t {
+    uint64_t time;
+    uint64_t latency;
+    uint16_t sw;
+    const uint8_t* payload;
+    uint16_t length;
+};
+
+static struct ins_t* ins_table[256];
+
+static struct outlier_t outliers[MAX_OUTLIERS];
+static size_t outlier_count;
+
+static void count_status(struct status_t* status, size_t* count, uint16_t sw) {
+    size_t i;
+
+    for (i = 0; i < *count; i++) {
+        if (status[i].sw == sw) {
+            break;
+        }
+    }
+
+    if (i == *count) {
+        if (i == MAX_STATUS) {
+            // Lump rare status words in with the last one kept
+            i--;
+        } else {
+            status[(*count)++].sw = sw;
+        }
+    }
+
+    status[i].count++;
+}
+
+static struct ins_t* ins_of(uint8_t ins) {
+    if (!ins_table[ins]) {
+        ins_table[ins] = calloc(1, sizeof(struct ins_t));
+    }
+
+    return ins_table[ins];
+}
+
+static bool same_command(const struct trace_record_t* a, const struct trace_record_t* b) {
+    return a->cla == b->cla && a->p1 == b->p1 && a->p2 == b->p2 &&
+        a->length == b->length && memcmp(a->payload, b->payload, a->length) == 0;
+}
+
+// Keeps the slowest signing commands, slowest first
+static void add_outlier(size_t limit, const struct outlier_t* outlier) {
+    size_t i;
+
+    if (outlier_count == limit && outliers[limit - 1].latency >= outlier->latency) {
+        return;
+    }
+
+    i = outlier_count < limit ? outlier_count++ : limit - 1;
+
+    while (i > 0 && outliers[i - 1].latency < outlier->latency) {
+        outliers[i] = outliers[i - 1];
+        i--;
+    }
+
+    outliers[i] = *outlier;
+}
+
+static const uint8_t* map_trace(const char* path, size_t* size) {
+    struct stat info;
+    const uint8_t* data;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        perror(path);
+        exit(2);
+    }
+
+    *size = info.st_size;
+    if (*size < TRACE_FILE_HEADER_SIZE) {
+        fprintf(stderr, "%s: not a trace\n", path);
+        exit(2);
+    }
+
+    data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        perror(path);
+        exit(2);
+    }
+
+    madvise((void*) data, *size, MADV_SEQUENTIAL);
+
+    if (memcmp(data, TRACE_MAGIC, 8) != 0 || data[8] != TRACE_VERSION) {
+        fprintf(stderr, "%s: not a version %d trace\n", path, TRACE_VERSION);
+        exit(2);
+    }
+
+    return data;
+}
+
+// Calls visit for each command and its response, NULL if it had none
+static uint64_t walk(
+    const uint8_t* data,
+    size_t size,
+    void (*visit)(const struct trace_record_t*, const struct trace_record_t*, void*),
+    void* user
+) {
+    struct trace_record_t record;
+    struct trace_record_t command;
+    bool pending = false;
+    uint64_t records = 0;
+    size_t offset = TRACE_FILE_HEADER_SIZE;
+    size_t length;
+
+    while ((length = trace_parse(data + offset, size - offset, &record)) > 0) {
+        offset += length;
+        records++;
+
+        if (record.direction == TRACE_COMMAND) {
+            if (pending) {
+                visit(&command, NULL, user);
+            }
+            command = record;
+            pending = true;
+        } else if (pending) {
+            visit(&command, &record, user);
+            pending = false;
+        }
+    }
+
+    if (pending) {
+        visit(&command, NULL, user);
+    }
+
+    if (offset != size) {
+        fprintf(stderr, "%zu bytes of a partial record at the end\n", size - offset);
+    }
+
+    return records;
+}
+
+static void visit_stats(
+    const struct trace_record_t* command,
+    const struct trace_record_t* response,
+    void* user
+) {
+    struct ins_t* ins = ins_of(command->ins);
+    UNUSED(user);
+
+    if (ins->has_last && same_command(&ins->last, command)) {
+        ins->retries++;
+        count_status(ins->retried_after, &ins->retried_after_count, ins->last_sw);
+    }
+
+    ins->last = *command;
+    ins->has_last = true;
+    ins->last_sw = response ? response->sw : 0;
+
+    if (!response) {
+        ins->unanswered++;
+        return;
+    }
+
+    uint64_t latency = response->time - command->time;
+    size_t band = 0;
+
+    while (band < BAND_COUNT - 1 && latency >= BANDS[band]) {
+        band++;
+    }
+
+    histogram_add(&ins->latency, latency);
+    ins->bands[band]++;
+    count_status(ins->status, &ins->status_count, response->sw);
+}
+
+struct outlier_pass_t {
+    uint64_t threshold;
+    size_t limit;
+    uint64_t count;
+};
+
+static void visit_outliers(
+    const struct trace_record_t* command,
+    const struct trace_record_t* response,
+    void* user
+) {
+    struct outlier_pass_t* pass = user;
+    struct outlier_t outlier;
+
+    if (!response || command->ins != INS_SIGN_TRANSACTION) {
+        return;
+    }
+
+    outlier.latency = response->time - command->time;
+    if (outlier.latency < pass->threshold) {
+        return;
+    }
+
+    outlier.time = command->time;
+    outlier.sw = response->sw;
+    outlier.payload = command->payload;
+    outlier.length = command->length;
+
+    pass->count++;
+    add_outlier(pass->limit, &outlier);
+}
+
+static void print_status(const struct status_t* status, size_t count, uint64_t total) {
+    for (size_t i = 0; i < count; i++) {
+        printf(" %04x %.1f%%", status[i].sw, 100.0 * status[i].count / total);
+    }
+}
+
+static void print_ins(uint8_t code, const struct ins_t* ins) {
+    const struct histogram_t* latency = &ins->latency;
+
+    printf(
+        "INS %02x: %llu commands",
+        code,
+        (unsigned long long) (latency->total + ins->unanswered)
+    );
+    if (ins->unanswered > 0) {
+        printf(", %llu unanswered", (unsigned long long) ins->unanswered);
+    }
+    printf("\n");
+
+    if (latency->total == 0) {
+        return;
+    }
+
+    printf(
+        "    ms    p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f\n",
+        histogram_percentile(latency, 50) / 1e6,
+        histogram_percentile(latency, 90) / 1e6,
+        histogram_percentile(latency, 99) / 1e6,
+        histogram_percentile(latency, 99.9) / 1e6,
+        latency->max / 1e6
+    );
+
+    printf("    bands ");
+    for (size_t band = 0; band < BAND_COUNT; band++) {
+        if (ins->bands[band] > 0) {
+            printf(" %s %.1f%%", BAND_NAMES[band], 100.0 * ins->bands[band] / latency->total);
+        }
+    }
+    printf("\n");
+
+    printf("    status");
+    print_status(ins->status, ins->status_count, latency->total);
+    printf("\n");
+
+    if (ins->retries > 0) {
+        printf("    retries %llu, after:", (unsigned long long) ins->retries);
+        print_status(ins->retried_after, ins->retried_after_count, ins->retries);
+        printf("\n");
+    }
+}
+
+// One line on what a signing command asked for, from the app's decoder
+static void describe_sign(const uint8_t* payload, uint16_t length, char* text, size_t size) {
+    volatile bool decoded = false;
+
+    if (length < 4) {
+        snprintf(text, size, "short data");
+        return;
+    }
+
+    memset(&G_command_context, 0, sizeof(G_command_context));
+    ctx.key_index = U4LE(payload, 0);
+
+    BEGIN_TRY {
+        TRY {
+            decode_transaction(payload + 4, length - 4);
+            classify_transaction();
+            decoded = true;
+        }
+        CATCH_ALL {
+            decoded = false;
+        }
+        FINALLY {
+            // explicitly do nothing
+        }
+    }
+    END_TRY;
+
+    if (!decoded) {
+        snprintf(text, size, "key #%u, undecodable %u-byte body", ctx.key_index, length - 4);
+        return;
+    }
+
+    char fee[HBAR_BUF_SIZE];
+    char operator[ACCOUNT_ID_SIZE];
+    const HederaAccountID* account = &ctx.transaction.transactionID.accountID;
+
+    hedera_format_hbar(fee, sizeof(fee), ctx.transaction.transactionFee);
+    hedera_format_entity_id(
+        operator,
+        sizeof(operator),
+        account->shardNum,
+        account->realmNum,
+        account->accountNum
+    );
+
+    snprintf(
+        text,
+        size,
+        "%s, key #%u, operator %s, fee %s, memo \"%s\"",
+        ctx.summary_line_1,
+        ctx.key_index,
+        operator,
+        fee,
+        ctx.transaction.memo
+    );
+}
+
+static void usage() {
+    fprintf(stderr, "usage: hedera_trace [-s ms] [-n outliers] trace.bin\n");
+    exit(2);
+}
+
+int main(int argc, char* argv[]) {
+    struct outlier_pass_t pass = { .limit = 10 };
+    double slow_ms = -1;
+    const uint8_t* data;
+    size_t size;
+    uint64_t records;
+    uint64_t started;
+    int arg;
+
+    for (arg = 1; arg < argc - 1 && argv[arg][0] == '-'; arg += 2) {
+        switch (argv[arg][1]) {
+            case 's':
+                slow_ms = strtod(argv[arg + 1], NULL);
+                break;
+
+            case 'n':
+                pass.limit = strtoul(argv[arg + 1], NULL, 10);
+                break;
+
+            default:
+                usage();
+        }
+    }
+
+    if (arg != argc - 1 || pass.limit == 0 || pass.limit > MAX_OUTLIERS) {
+        usage();
+    }
+
+    data = map_trace(argv[arg], &size);
+    started = 0;
+    for (int i = 7; i >= 0; i--) {
+        started = started << 8 | data[16 + i];
+    }
+
+    records = walk(data, size, visit_stats, NULL);
+
+    printf(
+        "%s: %llu records, started %llu.%09llu (Unix time)\n\n",
+        argv[arg],
+        (unsigned long long) records,
+        (unsigned long long) (started / 1000000000ULL),
+        (unsigned long long) (started % 1000000000ULL)
+    );
+
+    for (int ins = 0; ins < 256; ins++) {
+        if (ins_table[ins]) {
+            print_ins(ins, ins_table[ins]);
+        }
+    }
+
+    if (!ins_table[INS_SIGN_TRANSACTION] || ins_table[INS_SIGN_TRANSACTION]->latency.total == 0) {
+        return 0;
+    }
+
+    pass.threshold = slow_ms >= 0
+        ? (uint64_t) (slow_ms * 1e6)
+        : histogram_percentile(&ins_table[INS_SIGN_TRANSACTION]->latency, 99);
+
+    walk(data, size, visit_outliers, &pass);
+
+    printf(
+        "\n%llu signing commands at or above %.3f ms, slowest first:\n",
+        (unsigned long long) pass.count,
+        pass.threshold / 1e6
+    );
+
+    for (size_t i = 0; i < outlier_count; i++) {
+        char text[256];
+
+        describe_sign(outliers[i].payload, outliers[i].length, text, sizeof(text));
+
+        printf(
+            "  %12.3f s  %10.3f ms  %04x  %s\n",
+            outliers[i].time / 1e9,
+            outliers[i].latency / 1e6,
+            outliers[i].sw,
+            text
+        );
+    }
+
+    return 0;
+}
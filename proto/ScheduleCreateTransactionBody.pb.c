@@ -0,0 +1,15 @@
+/* Automatically generated nanopb constant definitions */
+/* Generated by nanopb-0.4.5 */
+
+#include "proto/ScheduleCreateTransactionBody.pb.h"
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+PB_BIND(HederaSchedulableTransactionBody, HederaSchedulableTransactionBody, AUTO)
+
+
+PB_BIND(HederaScheduleCreateTransactionBody, HederaScheduleCreateTransactionBody, 2)
+
+
+
@@ -0,0 +1,83 @@
+/* Automatically generated nanopb header */
+/* Generated by nanopb-0.4.5 */
+
+#ifndef PB_PROTO_SCHEDULECREATETRANSACTIONBODY_PB_H_INCLUDED
+#define PB_PROTO_SCHEDULECREATETRANSACTIONBODY_PB_H_INCLUDED
+#include <pb.h>
+#include "proto/CryptoCreateTransactionBody.pb.h"
+#include "proto/CryptoTransferTransactionBody.pb.h"
+
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+/* Struct definitions */
+typedef struct _HederaSchedulableTransactionBody { 
+    uint64_t transactionFee; 
+    char memo[100]; 
+    pb_size_t which_data;
+    union {
+        HederaCryptoCreateTransactionBody cryptoCreateAccount;
+        HederaCryptoTransferTransactionBody cryptoTransfer;
+    } data; 
+} HederaSchedulableTransactionBody;
+
+typedef struct _HederaScheduleCreateTransactionBody { 
+    bool has_scheduledTransactionBody;
+    HederaSchedulableTransactionBody scheduledTransactionBody; 
+    char memo[100]; 
+} HederaScheduleCreateTransactionBody;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initializer values for message structs */
+#define HederaSchedulableTransactionBody_init_default {0, "", 0, {HederaCryptoCreateTransactionBody_init_default}}
+#define HederaScheduleCreateTransactionBody_init_default {false, HederaSchedulableTransactionBody_init_default, ""}
+#define HederaSchedulableTransactionBody_init_zero {0, "", 0, {HederaCryptoCreateTransactionBody_init_zero}}
+#define HederaScheduleCreateTransactionBody_init_zero {false, HederaSchedulableTransactionBody_init_zero, ""}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define HederaSchedulableTransactionBody_transactionFee_tag 1
+#define HederaSchedulableTransactionBody_memo_tag 2
+#define HederaSchedulableTransactionBody_cryptoCreateAccount_tag 7
+#define HederaSchedulableTransactionBody_cryptoTransfer_tag 9
+#define HederaScheduleCreateTransactionBody_scheduledTransactionBody_tag 1
+#define HederaScheduleCreateTransactionBody_memo_tag 2
+
+/* Struct field encoding specification for nanopb */
+#define HederaSchedulableTransactionBody_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT64,   transactionFee,    1) \
+X(a, STATIC,   SINGULAR, STRING,   memo,              2) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (data,cryptoCreateAccount,data.cryptoCreateAccount),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (data,cryptoTransfer,data.cryptoTransfer),   9)
+#define HederaSchedulableTransactionBody_CALLBACK NULL
+#define HederaSchedulableTransactionBody_DEFAULT NULL
+#define HederaSchedulableTransactionBody_data_cryptoCreateAccount_MSGTYPE HederaCryptoCreateTransactionBody
+#define HederaSchedulableTransactionBody_data_cryptoTransfer_MSGTYPE HederaCryptoTransferTransactionBody
+
+#define HederaScheduleCreateTransactionBody_FIELDLIST(X, a) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  scheduledTransactionBody,   1) \
+X(a, STATIC,   SINGULAR, STRING,   memo,              2)
+#define HederaScheduleCreateTransactionBody_CALLBACK NULL
+#define HederaScheduleCreateTransactionBody_DEFAULT NULL
+#define HederaScheduleCreateTransactionBody_scheduledTransactionBody_MSGTYPE HederaSchedulableTransactionBody
+
+extern const pb_msgdesc_t HederaSchedulableTransactionBody_msg;
+extern const pb_msgdesc_t HederaScheduleCreateTransactionBody_msg;
+
+/* Defines for backwards compatibility with code written before nanopb-0.4.0 */
+#define HederaSchedulableTransactionBody_fields &HederaSchedulableTransactionBody_msg
+#define HederaScheduleCreateTransactionBody_fields &HederaScheduleCreateTransactionBody_msg
+
+/* Maximum encoded size of messages (where known) */
+#define HederaSchedulableTransactionBody_size    212
+#define HederaScheduleCreateTransactionBody_size 316
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -6,7 +6,7 @@
 #error Regenerate this file with the current version of nanopb generator.
 #endif
 
-PB_BIND(HederaTransactionBody, HederaTransactionBody, AUTO)
+PB_BIND(HederaTransactionBody, HederaTransactionBody, 2)
 
 
 
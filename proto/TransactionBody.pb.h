@@ -7,6 +7,7 @@
 #include "proto/BasicTypes.pb.h"
 #include "proto/CryptoCreateTransactionBody.pb.h"
 #include "proto/CryptoTransferTransactionBody.pb.h"
+#include "proto/ScheduleCreateTransactionBody.pb.h"
 
 #if PB_PROTO_HEADER_VERSION != 40
 #error Regenerate this file with the current version of nanopb generator.
@@ -23,6 +24,7 @@ typedef struct _HederaTransactionBody {
         HederaCryptoCreateTransactionBody cryptoCreateAccount;
         HederaCryptoTransferTransactionBody cryptoTransfer;
     } data; 
+    pb_callback_t scheduleCreate; 
 } HederaTransactionBody;
 
 
@@ -31,8 +33,8 @@ extern "C" {
 #endif
 
 /* Initializer values for message structs */
-#define HederaTransactionBody_init_default       {false, HederaTransactionID_init_default, 0, "", 0, {HederaCryptoCreateTransactionBody_init_default}}
-#define HederaTransactionBody_init_zero          {false, HederaTransactionID_init_zero, 0, "", 0, {HederaCryptoCreateTransactionBody_init_zero}}
+#define HederaTransactionBody_init_default       {false, HederaTransactionID_init_default, 0, "", 0, {HederaCryptoCreateTransactionBody_init_default}, {{NULL}, NULL}}
+#define HederaTransactionBody_init_zero          {false, HederaTransactionID_init_zero, 0, "", 0, {HederaCryptoCreateTransactionBody_init_zero}, {{NULL}, NULL}}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define HederaTransactionBody_transactionID_tag  1
@@ -40,6 +42,7 @@ extern "C" {
 #define HederaTransactionBody_memo_tag           6
 #define HederaTransactionBody_cryptoCreateAccount_tag 11
 #define HederaTransactionBody_cryptoTransfer_tag 14
+#define HederaTransactionBody_scheduleCreate_tag 42
 
 /* Struct field encoding specification for nanopb */
 #define HederaTransactionBody_FIELDLIST(X, a) \
@@ -47,12 +50,14 @@ X(a, STATIC,   OPTIONAL, MESSAGE,  transactionID,     1) \
 X(a, STATIC,   SINGULAR, UINT64,   transactionFee,    3) \
 X(a, STATIC,   SINGULAR, STRING,   memo,              6) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (data,cryptoCreateAccount,data.cryptoCreateAccount),  11) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (data,cryptoTransfer,data.cryptoTransfer),  14)
-#define HederaTransactionBody_CALLBACK NULL
+X(a, STATIC,   ONEOF,    MESSAGE,  (data,cryptoTransfer,data.cryptoTransfer),  14) \
+X(a, CALLBACK, OPTIONAL, MESSAGE,  scheduleCreate,   42)
+#define HederaTransactionBody_CALLBACK pb_default_field_callback
 #define HederaTransactionBody_DEFAULT NULL
 #define HederaTransactionBody_transactionID_MSGTYPE HederaTransactionID
 #define HederaTransactionBody_data_cryptoCreateAccount_MSGTYPE HederaCryptoCreateTransactionBody
 #define HederaTransactionBody_data_cryptoTransfer_MSGTYPE HederaCryptoTransferTransactionBody
+#define HederaTransactionBody_scheduleCreate_MSGTYPE HederaScheduleCreateTransactionBody
 
 extern const pb_msgdesc_t HederaTransactionBody_msg;
 
@@ -60,7 +65,7 @@ extern const pb_msgdesc_t HederaTransactionBody_msg;
 #define HederaTransactionBody_fields &HederaTransactionBody_msg
 
 /* Maximum encoded size of messages (where known) */
-#define HederaTransactionBody_size               249
+/* HederaTransactionBody_size depends on runtime parameters */
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Flash and RAM used by each object file and symbol, from a GNU ld map.
+
+    size_report.py --map debug/app.map [--symbols 20]
+    size_report.py --map debug/app.map --save baseline.json
+    size_report.py --map debug/app.map --baseline baseline.json
+
+Sizes come from the input sections the linker placed, so with
+-ffunction-sections and -fdata-sections every function and object is its own
+entry. Read-only sections count as flash, .bss as RAM, and .data as both.
+"""
+
+import argparse
+import collections
+import json
+import os
+import re
+import sys
+
+# " .text.name  0x00000000c0d00000  0x40 obj/file.o"; long section names
+# push the address, size and file onto the next line
+SECTION_RE = re.compile(r"^ (\.\S+|COMMON)(?:\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(.+))?$")
+CONTINUATION_RE = re.compile(r"^\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(.+)$")
+
+
+def memory_of(section):
+    """Returns (flash, ram) multipliers for an input section name."""
+    if section.startswith((".bss", "COMMON")):
+        return 0, 1
+    if section.startswith(".data"):
+        return 1, 1
+    if section.startswith((".text", ".rodata", ".nvram", ".glue", ".ARM")):
+        return 1, 0
+    return 0, 0
+
+
+def symbol_of(section, obj):
+    # ".text.handle_sign_transaction" -> "handle_sign_transaction"
+    for prefix in (".text.", ".rodata.", ".data.", ".bss.", ".nvram."):
+        if section.startswith(prefix):
+            return section[len(prefix):]
+    return "%s(%s)" % (section, obj)
+
+
+def object_of(path):
+    # "libc.a(memcpy.o)" and "obj/src/main.o" both become a short name
+    match = re.match(r".*/([^/(]+)\(([^)]+)\)$", path)
+    if match:
+        return "%s(%s)" % (match.group(1), match.group(2))
+    return os.path.normpath(path)
+
+
+def parse_map(path):
+    objects = collections.defaultdict(lambda: [0, 0])
+    symbols = collections.defaultdict(lambda: [0, 0])
+    pending = None
+    in_memory_map = False
+
+    with open(path) as map_file:
+        for line in map_file:
+            line = line.rstrip("\n")
+
+            if line.startswith("Linker script and memory map"):
+                in_memory_map = True
+                continue
+            if not in_memory_map or line.startswith("/DISCARD/"):
+                continue
+
+            match = SECTION_RE.match(line)
+            if match:
+                if match.group(2) is None:
+                    pending = match.group(1)
+                    continue
+                section, size, obj = match.group(1), match.group(3), match.group(4)
+            elif pending:
+                match = CONTINUATION_RE.match(line)
+                pending, section = None, pending
+                if not match:
+                    continue
+                size, obj = match.group(2), match.group(3)
+            else:
+                continue
+
+            size = int(size, 16)
+            flash, ram = memory_of(section)
+            if size == 0 or (flash, ram) == (0, 0):
+                continue
+
+            obj = object_of(obj.strip())
+            for totals in (objects[obj], symbols[symbol_of(section, obj)]):
+                totals[0] += size * flash
+                totals[1] += size * ram
+
+    return {"objects": dict(objects), "symbols": dict(symbols)}
+
+
+def print_table(title, entries, baseline, limit):
+    print("%-48s %8s %8s %8s %8s" % (title, "flash", "ram", "dflash", "dram"))
+
+    # Without a baseline nothing has changed; with one, a new entry grows
+    # from nothing and a removed one shrinks to nothing
+    names = set(entries) | set(baseline or {})
+    rows = []
+    for name in names:
+        flash, ram = entries.get(name, (0, 0))
+        if baseline is None:
+            old_flash, old_ram = flash, ram
+        else:
+            old_flash, old_ram = baseline.get(name, (0, 0))
+
+        label = name
+        if baseline is not None and name not in entries:
+            label = "(removed) " + name
+        elif baseline is not None and name not in baseline:
+            label = "(new) " + name
+        rows.append((label, flash, ram, flash - old_flash, ram - old_ram))
+
+    # Biggest first, then anything that changed even if it is small
+    rows.sort(key=lambda row: (-(row[1] + row[2]), row[0]))
+    changed = [row for row in rows[limit:] if row[3] or row[4]] if limit else []
+    for name, flash, ram, dflash, dram in (rows[:limit] if limit else rows) + changed:
+        print("%-48s %8d %8d %+8d %+8d" % (name[:48], flash, ram, dflash, dram))
+
+    total_flash = sum(row[1] for row in rows)
+    total_ram = sum(row[2] for row in rows)
+    print("%-48s %8d %8d %+8d %+8d\n" % (
+        "total", total_flash, total_ram,
+        sum(row[3] for row in rows), sum(row[4] for row in rows)
+    ))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--map", required=True)
+    parser.add_argument("--baseline")
+    parser.add_argument("--save")
+    parser.add_argument("--symbols", type=int, default=30,
+                        help="symbols to list, biggest first (0 for all)")
+    args = parser.parse_args()
+
+    report = parse_map(args.map)
+
+    if args.save:
+        with open(args.save, "w") as baseline_file:
+            json.dump(report, baseline_file, indent=1, sort_keys=True)
+        print("saved baseline to " + args.save)
+        return 0
+
+    baseline = {"objects": None, "symbols": None}
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as baseline_file:
+            baseline = json.load(baseline_file)
+
+    print_table("object", report["objects"], baseline["objects"], 0)
+    print_table("symbol", report["symbols"], baseline["symbols"], args.symbols)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Static worst-case stack usage of the APDU handlers.
+
+Combines the per-function frame sizes written by -fstack-usage (.su files)
+with the direct call graph of the linked app, read from its disassembly, and
+reports the deepest path from each root. Exits non-zero when a root goes over
+the budget or its depth cannot be bounded.
+
+    stack_usage.py --objdump arm-none-eabi-objdump --elf bin/app.elf \\
+        --su-dir obj --budget 2048 \\
+        --indirect decode_callback_field:pb_default_field_callback \\
+        --recursion pb_decode_inner:5 \\
+        --leaf io_exchange:1024 \\
+        handle_get_app_configuration handle_get_public_key handle_sign_transaction
+
+Calls through function pointers (blx or bx to a register) have no target in
+the disassembly. Each function on a path that makes one must be declared with
+--indirect caller:callee for every function it can reach that way, or with
+--indirect caller: when the pointer is always NULL there; an undeclared one
+fails the check. Recursive cycles are allowed only through functions given a
+--recursion name:max_frames limit.
+
+A function given with --leaf name:bytes is charged that many bytes for
+itself and everything below it, and its calls are not followed. This is for
+SDK entry points whose call graph runs through callbacks the disassembly
+cannot resolve; the charge is an allowance, not a measurement.
+"""
+
+import argparse
+import collections
+import os
+import re
+import subprocess
+import sys
+
+# "0000c0de <name>:" starts a function, "bl 0000c0de <name>" calls one. A
+# target with an offset ("<name+0x12>") is a branch inside a function.
+FUNCTION_RE = re.compile(r"^[0-9a-f]+ <([^>]+)>:$")
+CALL_RE = re.compile(r"\s(?:bl|blx|b\.w|b|call|jmp)\s+[0-9a-f]+\s+<([^>+]+)>")
+
+# "blx r3", or "bx r3" as a tail call; "bx lr" is a return
+INDIRECT_RE = re.compile(r"\s(?:blx|bx)\s+(?!lr\b)(?:r\d+|ip|sl|fp)\b")
+
+
+def read_frames(su_dir):
+    frames = {}
+    unbounded = set()
+
+    for root, _, files in os.walk(su_dir):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+
+            with open(os.path.join(root, name)) as su:
+                for line in su:
+                    location, size, qualifiers = line.rstrip("\n").split("\t")
+                    function = location.split(":")[-1]
+
+                    # Static functions may share a name across files
+                    frames[function] = max(frames.get(function, 0), int(size))
+                    if qualifiers == "dynamic":
+                        unbounded.add(function)
+
+    return frames, unbounded
+
+
+def read_calls(objdump, elf):
+    calls = collections.defaultdict(set)
+    indirect = set()
+    function = None
+
+    disassembly = subprocess.run(
+        [objdump, "-d", elf], check=True, capture_output=True, text=True
+    ).stdout
+
+    for line in disassembly.splitlines():
+        start = FUNCTION_RE.match(line)
+        if start:
+            function = start.group(1)
+            continue
+
+        call = CALL_RE.search(line)
+        if function and call:
+            calls[function].add(call.group(1))
+        elif function and INDIRECT_RE.search(line):
+            indirect.add(function)
+
+    return calls, indirect
+
+
+class Analysis:
+    def __init__(self, frames, unbounded, calls, undeclared, recursion, leaves):
+        self.frames = frames
+        self.unbounded = unbounded
+        self.calls = calls
+        self.undeclared = undeclared
+        self.recursion = recursion
+        self.leaves = leaves
+        self.missing = set()
+        self.errors = []
+        self.memo = {}
+
+    def deepest(self, function, path):
+        """Returns (bytes, call chain) of the deepest path from function."""
+        if function in self.leaves:
+            return self.leaves[function], [function + " (fixed)"]
+
+        depth = path.count(function)
+        if depth >= self.recursion.get(function, 1):
+            if function not in self.recursion:
+                self.errors.append(
+                    "unbounded recursion: " + " -> ".join(path + [function])
+                )
+            return 0, []
+
+        # Only the recursive frames on the path change the answer
+        key = (function,) + tuple(path.count(name) for name in self.recursion)
+        if key in self.memo:
+            return self.memo[key]
+
+        if function in self.unbounded:
+            self.errors.append("dynamic stack allocation in " + function)
+        if function in self.undeclared:
+            self.errors.append("undeclared indirect call in " + function)
+        if function not in self.frames:
+            # Assembly and SDK stubs have no .su entry
+            self.missing.add(function)
+
+        best, chain = 0, []
+        for callee in sorted(self.calls.get(function, ())):
+            size, callee_chain = self.deepest(callee, path + [function])
+            if size > best:
+                best, chain = size, callee_chain
+
+        self.memo[key] = self.frames.get(function, 0) + best, [function] + chain
+        return self.memo[key]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--objdump", default="objdump")
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--su-dir", required=True)
+    parser.add_argument("--budget", type=int, required=True)
+    parser.add_argument("--indirect", action="append", default=[])
+    parser.add_argument("--recursion", action="append", default=[])
+    parser.add_argument("--leaf", action="append", default=[])
+    parser.add_argument("roots", nargs="+")
+    args = parser.parse_args()
+
+    frames, unbounded = read_frames(args.su_dir)
+    calls, indirect = read_calls(args.objdump, args.elf)
+    declared = set()
+
+    for edge in args.indirect:
+        caller, callee = edge.split(":")
+        declared.add(caller)
+        if callee:
+            calls[caller].add(callee)
+
+    recursion = {}
+    for limit in args.recursion:
+        name, frames_allowed = limit.split(":")
+        recursion[name] = int(frames_allowed)
+
+    leaves = {}
+    for leaf in args.leaf:
+        name, charge = leaf.split(":")
+        leaves[name] = int(charge)
+
+    analysis = Analysis(
+        frames, unbounded, calls, indirect - declared, recursion, leaves
+    )
+    failed = False
+
+    for root in args.roots:
+        if root not in frames:
+            print("%s: no stack usage data" % root)
+            failed = True
+            continue
+
+        size, chain = analysis.deepest(root, [])
+        status = "ok" if size <= args.budget else "OVER BUDGET"
+        failed |= size > args.budget
+
+        print("%s: %d bytes (budget %d) %s" % (root, size, args.budget, status))
+        print("    " + " -> ".join(chain))
+
+    if analysis.missing:
+        print("no frame size for: " + ", ".join(sorted(analysis.missing)))
+
+    for error in sorted(set(analysis.errors)):
+        print(error)
+        failed = True
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
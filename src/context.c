@@ -0,0 +1,22 @@
+#include <string.h>
+
+#include "context.h"
+#include "handlers.h"
+#include "ui.h"
+
+union command_context_t G_command_context;
+
+// INS of the command that owns G_command_context, 0 if none
+static uint8_t owner;
+
+void claim_command_context(uint8_t ins) {
+    if (owner == ins) return;
+
+    if (owner != 0) {
+        // The old command may still have a review or compare screen up
+        ui_idle();
+    }
+
+    memset(&G_command_context, 0, sizeof(G_command_context));
+    owner = ins;
+}
@@ -0,0 +1,24 @@
+#ifndef LEDGER_HEDERA_CONTEXT_H
+#define LEDGER_HEDERA_CONTEXT_H 1
+
+#include <stdint.h>
+
+#include "ui.h"
+#include "get_public_key.h"
+#include "sign_transaction.h"
+
+// Only one command is ever in flight, so their contexts share one arena
+// instead of each holding its own RAM for the life of the app
+union command_context_t {
+    struct get_public_key_context_t get_public_key;
+    struct sign_tx_context_t sign_transaction;
+};
+
+extern union command_context_t G_command_context;
+
+// Hands the arena to the command with the given INS. When it changes
+// hands, the previous command's screen is dismissed and the arena cleared,
+// so no UI callback can read another command's context.
+extern void claim_command_context(uint8_t ins);
+
+#endif // LEDGER_HEDERA_CONTEXT_H
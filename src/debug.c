@@ -1,5 +1,9 @@
 #include "os.h"
 #include "debug.h"
+#include "errors.h"
+#include "handlers.h"
+#include "io.h"
+#include "stats.h"
 
 // This symbol is defined by the link script to be at the start of the stack
 // area.
@@ -20,3 +24,176 @@ void debug_check_stack_canary() {
 uint32_t debug_get_stack_canary() {
     return STACK_CANARY;
 }
+
+#ifdef HAVE_DEBUG_INS
+// Every free stack word is painted with STACK_PAINT; the lowest word that
+// no longer holds it is the deepest the stack has reached. Depths are
+// counted in bytes from the top of the stack, as seen from main().
+#define STACK_PAINT 0xA5A5A5A5
+
+// Words left unpainted below the caller's stack pointer, covering the
+// painting code's own frame
+#define STACK_PAINT_MARGIN 16
+
+// Per-command peaks are kept for INS values below this
+#define STACK_COMMAND_SLOTS 0x20
+
+static uint32_t* stack_top;
+static uint16_t stack_peak;
+static uint16_t command_peaks[STACK_COMMAND_SLOTS];
+static uint8_t current_ins;
+
+// Trace records, oldest overwritten first once the ring is full. Its RAM
+// and the DEBUG_TRACE calls exist only in DEBUG_INS=1 builds.
+#define TRACE_SIZE 32
+
+struct trace_record_t {
+    uint8_t event;
+    uint8_t ins;
+    uint32_t tick;
+};
+
+static struct trace_record_t trace[TRACE_SIZE];
+static uint8_t trace_next;
+static uint8_t trace_count;
+
+static uint32_t* stack_pointer() {
+    uint32_t* sp;
+    __asm volatile("mov %0, sp" : "=r"(sp));
+    return sp;
+}
+
+static void paint_below(uint32_t* sp) {
+    for (
+        volatile uint32_t* word = (uint32_t*) &app_stack_canary + 1;
+        word < sp - STACK_PAINT_MARGIN;
+        word++
+    ) {
+        *word = STACK_PAINT;
+    }
+}
+
+static uint16_t stack_depth() {
+    uint32_t* word = (uint32_t*) &app_stack_canary + 1;
+
+    while (word < stack_top && *word == STACK_PAINT) {
+        word++;
+    }
+
+    return (stack_top - word) * sizeof(uint32_t);
+}
+
+// Called once at boot, from main()
+void debug_paint_stack() {
+    stack_top = stack_pointer();
+    paint_below(stack_top);
+}
+
+// Charges the stack used since the last call to the command that was
+// running, then repaints so the next command is measured on its own
+void debug_begin_command(uint8_t ins) {
+    uint16_t depth = stack_depth();
+
+    if (depth > stack_peak) stack_peak = depth;
+
+    if (current_ins < STACK_COMMAND_SLOTS &&
+        depth > command_peaks[current_ins]) {
+        command_peaks[current_ins] = depth;
+    }
+
+    current_ins = ins;
+    paint_below(stack_pointer());
+
+    debug_trace(TRACE_APDU_RECEIVED);
+}
+
+void debug_trace(enum DebugTraceEvent event) {
+    struct trace_record_t* record = &trace[trace_next];
+
+    record->event = event;
+    record->ins = current_ins;
+    record->tick = stats_ticks();
+
+    trace_next = (trace_next + 1) % TRACE_SIZE;
+    if (trace_count < TRACE_SIZE) trace_count++;
+}
+
+// Returns the stack size, the peak depth since boot and, for each command
+// that has run since the last reset, its INS and peak depth:
+//   size (2) | peak (2) | { ins (1) | peak (2) }*
+// All values are big-endian byte counts. P1 = 1 resets the per-command
+// peaks after reading them.
+void handle_get_stack_usage(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t* buffer,
+    uint16_t len,
+    /* out */ volatile unsigned int* flags,
+    /* out */ volatile unsigned int* tx
+) {
+    UNUSED(p2);
+    UNUSED(buffer);
+    UNUSED(len);
+    UNUSED(flags);
+    UNUSED(tx);
+
+    uint16_t size = (stack_top - (uint32_t*) &app_stack_canary) * sizeof(uint32_t);
+    uint16_t length = 0;
+
+    G_io_apdu_buffer[length++] = size >> 8;
+    G_io_apdu_buffer[length++] = size & 0xFF;
+    G_io_apdu_buffer[length++] = stack_peak >> 8;
+    G_io_apdu_buffer[length++] = stack_peak & 0xFF;
+
+    for (uint8_t ins = 0; ins < STACK_COMMAND_SLOTS; ins++) {
+        if (command_peaks[ins] == 0) continue;
+
+        G_io_apdu_buffer[length++] = ins;
+        G_io_apdu_buffer[length++] = command_peaks[ins] >> 8;
+        G_io_apdu_buffer[length++] = command_peaks[ins] & 0xFF;
+
+        if (p1 == 1) command_peaks[ins] = 0;
+    }
+
+    io_exchange_with_code(EXCEPTION_OK, length);
+}
+
+// Returns the trace, oldest record first:
+//   count (1) | { event (1) | ins (1) | tick (4) }*
+// Ticks are big-endian counts of SEPROXYHAL ticker events. P1 = 1 clears
+// the trace after reading it.
+void handle_get_trace(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t* buffer,
+    uint16_t len,
+    /* out */ volatile unsigned int* flags,
+    /* out */ volatile unsigned int* tx
+) {
+    UNUSED(p2);
+    UNUSED(buffer);
+    UNUSED(len);
+    UNUSED(flags);
+    UNUSED(tx);
+
+    uint8_t first = (trace_next + TRACE_SIZE - trace_count) % TRACE_SIZE;
+    uint16_t length = 0;
+
+    G_io_apdu_buffer[length++] = trace_count;
+
+    for (uint8_t i = 0; i < trace_count; i++) {
+        const struct trace_record_t* record = &trace[(first + i) % TRACE_SIZE];
+
+        G_io_apdu_buffer[length++] = record->event;
+        G_io_apdu_buffer[length++] = record->ins;
+        G_io_apdu_buffer[length++] = record->tick >> 24;
+        G_io_apdu_buffer[length++] = (record->tick >> 16) & 0xFF;
+        G_io_apdu_buffer[length++] = (record->tick >> 8) & 0xFF;
+        G_io_apdu_buffer[length++] = record->tick & 0xFF;
+    }
+
+    if (p1 == 1) trace_count = 0;
+
+    io_exchange_with_code(EXCEPTION_OK, length);
+}
+#endif // HAVE_DEBUG_INS
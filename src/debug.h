@@ -9,4 +9,29 @@ extern uint32_t debug_get_stack_canary();
 
 extern void debug_check_stack_canary();
 
+#ifdef HAVE_DEBUG_INS
+extern void debug_paint_stack();
+
+extern void debug_begin_command(uint8_t ins);
+
+// Points in a command recorded by the trace
+enum DebugTraceEvent {
+    TRACE_APDU_RECEIVED = 1,
+    TRACE_HANDLER_RETURNED = 2,
+    TRACE_RESPONSE_SENT = 3,
+    TRACE_TX_COPIED = 4,
+    TRACE_KEY_DERIVED = 5,
+    TRACE_TX_SIGNED = 6,
+    TRACE_TX_DECODED = 7,
+    TRACE_TX_FORMATTED = 8,
+    TRACE_UI_DISPLAYED = 9
+};
+
+extern void debug_trace(enum DebugTraceEvent event);
+
+#define DEBUG_TRACE(event) debug_trace(event)
+#else
+#define DEBUG_TRACE(event)
+#endif // HAVE_DEBUG_INS
+
 #endif // LEDGER_HEDERA_DEBUG_H
@@ -1,9 +1,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
-#include "globals.h"
-#include "printf.h"
 #include "globals.h"
 #include "debug.h"
 #include "errors.h"
@@ -13,35 +12,34 @@
 #include "utils.h"
 #include "ui.h"
 #include "get_public_key.h"
+#include "context.h"
 
-static struct get_public_key_context_t {
-    uint32_t key_index;
-
-    // Lines on the UI Screen
-    char ui_approve_l2[DISPLAY_SIZE + 1];
-
-    cx_ecfp_public_key_t public;
-
-    // Public Key Compare
-    uint8_t display_index;
-    uint8_t full_key[KEY_SIZE + 1];
-    uint8_t partial_key[DISPLAY_SIZE + 1];
-} ctx;
+// This command's context lives in the shared command arena
+#define ctx (G_command_context.get_public_key)
 
 #if defined(TARGET_NANOS)
 
 static const bagl_element_t ui_get_public_key_compare[] = {
     UI_BACKGROUND(),
-    UI_ICON_LEFT(LEFT_ICON_ID, BAGL_GLYPH_ICON_LEFT),
-    UI_ICON_RIGHT(RIGHT_ICON_ID, BAGL_GLYPH_ICON_RIGHT),
     // <=                  =>
     //      Public Key
     //      <partial>
     //
     UI_TEXT(LINE_1_ID, 0, 12, 128, "Public Key"),
-    UI_TEXT(LINE_2_ID, 0, 26, 128, ctx.partial_key)
+
+    // The key line spans the full width, under the lower rows of the
+    // arrows, so the arrows are drawn after it
+    UI_CLEAR(0, 0, 16, 128, 16),
+    UI_TEXT(LINE_2_ID, 0, 26, 128, ctx.partial_key),
+    UI_ICON_LEFT(LEFT_ICON_ID, BAGL_GLYPH_ICON_LEFT),
+    UI_ICON_RIGHT(RIGHT_ICON_ID, BAGL_GLYPH_ICON_RIGHT)
 };
 
+// Scrolling only changes the key: redraw from UI_CLEAR onwards, which
+// repaints the key line and the arrows (4 of the 6 elements), unless an
+// arrow has to appear or disappear
+#define PARTIAL_KEY_IDX 2
+
 static const bagl_element_t ui_get_public_key_approve[] = {
     UI_BACKGROUND(),
     UI_ICON_LEFT(LEFT_ICON_ID, BAGL_GLYPH_ICON_CROSS),
@@ -62,23 +60,38 @@ void shift_partial_key() {
     );
 }
 
+static bool at_key_edge(uint8_t index) {
+    return index == 0 || index == KEY_SIZE - DISPLAY_SIZE;
+}
+
+static void redisplay_partial_key(uint8_t previous_index) {
+    if (ctx.display_index == previous_index) return;
+
+    shift_partial_key();
+
+    if (at_key_edge(previous_index) || at_key_edge(ctx.display_index)) {
+        UX_REDISPLAY();
+    } else {
+        UX_REDISPLAY_IDX(PARTIAL_KEY_IDX);
+    }
+}
+
 static unsigned int ui_get_public_key_compare_button(
     unsigned int button_mask, 
     unsigned int button_mask_counter
 ) {
     UNUSED(button_mask_counter);
+    uint8_t previous_index = ctx.display_index;
     switch (button_mask) {
         case BUTTON_LEFT: // Left
         case BUTTON_EVT_FAST | BUTTON_LEFT:
             if (ctx.display_index > 0) ctx.display_index--;
-            shift_partial_key();
-            UX_REDISPLAY();
+            redisplay_partial_key(previous_index);
             break;
         case BUTTON_RIGHT: // Right
         case BUTTON_EVT_FAST | BUTTON_RIGHT:
             if (ctx.display_index < KEY_SIZE - DISPLAY_SIZE) ctx.display_index++;
-            shift_partial_key();
-            UX_REDISPLAY();
+            redisplay_partial_key(previous_index);
             break;
         case BUTTON_EVT_RELEASED | BUTTON_LEFT | BUTTON_RIGHT: // Continue
             ui_idle();
@@ -238,7 +251,7 @@ void handle_get_public_key(
     // Only do UI actions for p1 == 0
     if (p1 == 0) {
         // Complete "Export Public | Key #x?"
-        hedera_snprintf(ctx.ui_approve_l2, DISPLAY_SIZE, "Key #%u?", ctx.key_index);
+        hedera_format_key_label(ctx.ui_approve_l2, DISPLAY_SIZE, "", ctx.key_index);
     }
 
     // Populate context with PK
@@ -1,6 +1,26 @@
 #ifndef LEDGER_HEDERA_GET_PUBLIC_KEY_H
 #define LEDGER_HEDERA_GET_PUBLIC_KEY_H 1
 
+#include <stdint.h>
+#include <os.h>
+#include <cx.h>
+
+#include "globals.h"
+
+struct get_public_key_context_t {
+    uint32_t key_index;
+
+    // Lines on the UI Screen
+    char ui_approve_l2[DISPLAY_SIZE + 1];
+
+    cx_ecfp_public_key_t public;
+
+    // Public Key Compare
+    uint8_t display_index;
+    uint8_t full_key[KEY_SIZE + 1];
+    uint8_t partial_key[DISPLAY_SIZE + 1];
+};
+
 void get_pk();
 void compare_pk();
 
@@ -8,22 +28,8 @@ void compare_pk();
 
 void shift_partial_key();
 
-static unsigned int ui_get_public_key_compare_button(
-    unsigned int button_mask,
-    unsigned int button_mask_counter
-);
-
-static const bagl_element_t* ui_prepro_get_public_key_compare(
-    const bagl_element_t* element
-);
-
 void send_pk();
 
-static unsigned int ui_get_public_key_approve_button(
-    unsigned int button_mask,
-    unsigned int button_mask_counter
-);
-
 #elif defined(TARGET_NANOX) || defined(TARGET_NANOS2)
 
 unsigned int io_seproxyhal_touch_pk_ok(const bagl_element_t *e);
@@ -8,6 +8,13 @@
 #define INS_GET_APP_CONFIGURATION 0x01
 #define INS_GET_PUBLIC_KEY 0x02
 #define INS_SIGN_TRANSACTION 0x04
+#define INS_GET_STATS 0x05
+
+#ifdef HAVE_DEBUG_INS
+// Only in builds made with DEBUG_INS=1
+#define INS_GET_STACK_USAGE 0x10
+#define INS_GET_TRACE 0x11
+#endif // HAVE_DEBUG_INS
 
 typedef void handler_fn_t(
     uint8_t p1,
@@ -21,5 +28,11 @@ typedef void handler_fn_t(
 extern handler_fn_t handle_get_app_configuration;
 extern handler_fn_t handle_get_public_key;
 extern handler_fn_t handle_sign_transaction;
+extern handler_fn_t handle_get_stats;
+
+#ifdef HAVE_DEBUG_INS
+extern handler_fn_t handle_get_stack_usage;
+extern handler_fn_t handle_get_trace;
+#endif // HAVE_DEBUG_INS
 
 #endif // LEDGER_HEDERA_HANDLERS_H
@@ -1,7 +1,7 @@
 #include <os.h>
 #include <cx.h>
 #include "globals.h"
-#include "printf.h"
+#include "debug.h"
 #include "hedera.h"
 #include "string.h"
 
@@ -59,6 +59,8 @@ void hedera_derive_keypair(
 
     explicit_bzero(seed, sizeof(seed));
     explicit_bzero(&pk, sizeof(pk));
+
+    DEBUG_TRACE(TRACE_KEY_DERIVED);
 }
 
 void hedera_sign(
@@ -91,26 +93,195 @@ void hedera_sign(
 
     // Clear private key
     explicit_bzero(&pk, sizeof(pk));
+
+    DEBUG_TRACE(TRACE_TX_SIGNED);
+}
+
+// Powers of ten used to peel off decimal digits by repeated subtraction.
+// 64-bit division is a software routine (__aeabi_uldivmod) on Cortex-M0,
+// so the conversion below never divides. Digits above 10^9 need 64-bit
+// arithmetic; the remainder after them always fits in 32 bits.
+static const uint64_t POW10_HIGH[] = {
+    10000000000000000000ULL, 1000000000000000000ULL, 100000000000000000ULL,
+    10000000000000000ULL, 1000000000000000ULL, 100000000000000ULL,
+    10000000000000ULL, 1000000000000ULL, 100000000000ULL,
+    10000000000ULL, 1000000000ULL
+};
+
+static const uint32_t POW10_LOW[] = {
+    100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+};
+
+// Digits of UINT64_MAX
+#define U64_DIGITS 20
+
+// The last 8 of those digits are tinybar
+#define TINYBAR_DIGITS 8
+
+// Writes all U64_DIGITS decimal digits of value, zero padded
+static void decimal_digits(char* digits, uint64_t value) {
+    size_t pos = 0;
+
+    for (size_t i = 0; i < sizeof(POW10_HIGH) / sizeof(POW10_HIGH[0]); i++) {
+        char digit = '0';
+        while (value >= POW10_HIGH[i]) {
+            value -= POW10_HIGH[i];
+            digit++;
+        }
+        digits[pos++] = digit;
+    }
+
+    uint32_t rest = (uint32_t) value;
+
+    for (size_t i = 0; i < sizeof(POW10_LOW) / sizeof(POW10_LOW[0]); i++) {
+        char digit = '0';
+        while (rest >= POW10_LOW[i]) {
+            rest -= POW10_LOW[i];
+            digit++;
+        }
+        digits[pos++] = digit;
+    }
+}
+
+// Appends n characters of src at dst[len], truncating to size - 1 and
+// keeping dst terminated. size must be > 0. Returns the new length.
+static size_t append(
+    char* dst,
+    size_t size,
+    size_t len,
+    const char* src,
+    size_t n
+) {
+    if (n > size - 1 - len) {
+        n = size - 1 - len;
+    }
+
+    memmove(dst + len, src, n);
+    len += n;
+    dst[len] = '\0';
+
+    return len;
+}
+
+static size_t append_str(char* dst, size_t size, size_t len, const char* src) {
+    return append(dst, size, len, src, strlen(src));
+}
+
+static size_t append_u64(char* dst, size_t size, size_t len, uint64_t value) {
+    char digits[U64_DIGITS];
+    size_t start = 0;
+
+    decimal_digits(digits, value);
+
+    // Skip leading zeros, but keep the units digit
+    while (start < U64_DIGITS - 1 && digits[start] == '0') {
+        start++;
+    }
+
+    return append(dst, size, len, digits + start, U64_DIGITS - start);
+}
+
+size_t hedera_format_tinybar(char* dst, size_t size, uint64_t tinybar) {
+    char digits[U64_DIGITS];
+    const size_t point = U64_DIGITS - TINYBAR_DIGITS;
+    size_t start = 0;
+    size_t end = U64_DIGITS;
+    size_t len;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    decimal_digits(digits, tinybar);
+
+    // Skip leading zeros, but keep the units digit of the hbar part
+    while (start < point - 1 && digits[start] == '0') {
+        start++;
+    }
+
+    // Trim trailing zeros of the fraction
+    while (end > point && digits[end - 1] == '0') {
+        end--;
+    }
+
+    len = append(dst, size, 0, digits + start, point - start);
+
+    if (end > point) {
+        len = append(dst, size, len, ".", 1);
+        len = append(dst, size, len, digits + point, end - point);
+    }
+
+    return len;
+}
+
+size_t hedera_format_hbar(char* dst, size_t size, uint64_t tinybar) {
+    size_t len = hedera_format_tinybar(dst, size, tinybar);
+
+    if (size == 0) {
+        return 0;
+    }
+
+    return append_str(dst, size, len, " hbar");
+}
+
+size_t hedera_format_entity_id(
+    char* dst,
+    size_t size,
+    uint64_t shard,
+    uint64_t realm,
+    uint64_t num
+) {
+    size_t len;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    len = append_u64(dst, size, 0, shard);
+    len = append(dst, size, len, ".", 1);
+    len = append_u64(dst, size, len, realm);
+    len = append(dst, size, len, ".", 1);
+
+    return append_u64(dst, size, len, num);
+}
+
+size_t hedera_format_counter_title(
+    char* dst,
+    size_t size,
+    const char* title,
+    uint32_t index,
+    uint32_t count
+) {
+    size_t len;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    len = append_str(dst, size, 0, title);
+    len = append(dst, size, len, " (", 2);
+    len = append_u64(dst, size, len, index);
+    len = append(dst, size, len, "/", 1);
+    len = append_u64(dst, size, len, count);
+
+    return append(dst, size, len, ")", 1);
 }
 
-char* hedera_format_tinybar(uint64_t tinybar) {
-    static char buf[HBAR_BUF_SIZE];
-    static uint64_t hbar;
-    static uint64_t hbar_f;
-    static int cnt;
-    
-    memset(buf, '\0', HBAR_BUF_SIZE);
-    cnt = 0;
-    
-    hbar = tinybar / HBAR;
-    hbar_f = tinybar % HBAR; 
-
-    cnt = hedera_snprintf(buf, HBAR_BUF_SIZE, "%llu", hbar);
-
-    if (hbar_f != 0) {
-        cnt += hedera_snprintf(buf + cnt, HBAR_BUF_SIZE - cnt, ".%.8llu", hbar_f);
+size_t hedera_format_key_label(
+    char* dst,
+    size_t size,
+    const char* prefix,
+    uint32_t key_index
+) {
+    size_t len;
+
+    if (size == 0) {
+        return 0;
     }
 
-    buf[cnt] = '\0';
-    return buf;
-}
\ No newline at end of file
+    len = append_str(dst, size, 0, prefix);
+    len = append(dst, size, len, "Key #", 5);
+    len = append_u64(dst, size, len, key_index);
+
+    return append(dst, size, len, "?", 1);
+}
@@ -1,6 +1,7 @@
 #ifndef LEDGER_HEDERA_HEDERA_H
 #define LEDGER_HEDERA_HEDERA_H 1
 
+#include <stddef.h>
 #include <stdint.h>
 
 // Forward declare to avoid including os.h in a header file
@@ -20,6 +21,41 @@ extern void hedera_sign(
     /* out */ uint8_t* result
 );
 
-extern char* hedera_format_tinybar(uint64_t tinybar);
+// Typed replacements for the few hedera_snprintf patterns the app needs.
+// Each writes at most size - 1 characters into dst, always terminates it
+// (unless size is 0) and returns the number of characters written.
 
-#endif // LEDGER_HEDERA_HEDERA_H
\ No newline at end of file
+// tinybar as a decimal hbar amount with trailing zeros trimmed,
+// 150000000 -> "1.5". HBAR_BUF_SIZE always fits.
+extern size_t hedera_format_tinybar(char* dst, size_t size, uint64_t tinybar);
+
+// "<amount> hbar"
+extern size_t hedera_format_hbar(char* dst, size_t size, uint64_t tinybar);
+
+// "<shard>.<realm>.<num>"
+extern size_t hedera_format_entity_id(
+    char* dst,
+    size_t size,
+    uint64_t shard,
+    uint64_t realm,
+    uint64_t num
+);
+
+// "<title> (<index>/<count>)"
+extern size_t hedera_format_counter_title(
+    char* dst,
+    size_t size,
+    const char* title,
+    uint32_t index,
+    uint32_t count
+);
+
+// "<prefix>Key #<key_index>?"
+extern size_t hedera_format_key_label(
+    char* dst,
+    size_t size,
+    const char* prefix,
+    uint32_t key_index
+);
+
+#endif // LEDGER_HEDERA_HEDERA_H
@@ -2,6 +2,7 @@
 #include "ux.h"
 #include "os_io_seproxyhal.h"
 #include "debug.h"
+#include "stats.h"
 
 // Everything below this point is Ledger magic. And the magic isn't well-
 // documented, so if you want to understand it, you'll need to read the
@@ -43,6 +44,7 @@ unsigned char io_event(unsigned char channel) {
             break;
 
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            stats_tick();
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {});
             break;
 
@@ -90,5 +92,9 @@ void io_exchange_with_code(uint16_t code, uint16_t tx) {
     G_io_apdu_buffer[tx++] = code >> 8;
     G_io_apdu_buffer[tx++] = code & 0xff;
 
+    stats_end_command(code);
+
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+
+    DEBUG_TRACE(TRACE_RESPONSE_SENT);
 }
@@ -5,6 +5,8 @@
 #include "utils.h"
 #include "debug.h"
 #include "globals.h"
+#include "context.h"
+#include "stats.h"
 
 // This is the main loop that reads and writes APDUs. It receives request
 // APDUs from the computer, looks up the corresponding command handler, and
@@ -37,6 +39,15 @@ void app_main() {
                     THROW(EXCEPTION_IO_RESET);
                 }
 
+                stats_begin_command(
+                    G_io_apdu_buffer[OFFSET_CLA],
+                    G_io_apdu_buffer[OFFSET_INS]
+                );
+
+#ifdef HAVE_DEBUG_INS
+                debug_begin_command(G_io_apdu_buffer[OFFSET_INS]);
+#endif // HAVE_DEBUG_INS
+
                 // malformed APDU
                 if (G_io_apdu_buffer[OFFSET_CLA] != CLA) {
                     THROW(EXCEPTION_MALFORMED_APDU);
@@ -58,6 +69,7 @@ void app_main() {
 
                     case INS_GET_PUBLIC_KEY:
                         // handlers -> get_public_key
+                        claim_command_context(INS_GET_PUBLIC_KEY);
                         handle_get_public_key(
                             G_io_apdu_buffer[OFFSET_P1], 
                             G_io_apdu_buffer[OFFSET_P2],
@@ -70,6 +82,7 @@ void app_main() {
 
                     case INS_SIGN_TRANSACTION:
                         // handlers -> sign_transaction
+                        claim_command_context(INS_SIGN_TRANSACTION);
                         handle_sign_transaction(
                             G_io_apdu_buffer[OFFSET_P1], 
                             G_io_apdu_buffer[OFFSET_P2],
@@ -80,9 +93,49 @@ void app_main() {
                         );
                         break;
 
+                    case INS_GET_STATS:
+                        // handlers -> stats
+                        handle_get_stats(
+                            G_io_apdu_buffer[OFFSET_P1], 
+                            G_io_apdu_buffer[OFFSET_P2],
+                            G_io_apdu_buffer + OFFSET_CDATA, 
+                            G_io_apdu_buffer[OFFSET_LC], 
+                            &flags, 
+                            &tx
+                        );
+                        break;
+
+#ifdef HAVE_DEBUG_INS
+                    case INS_GET_STACK_USAGE:
+                        // debug
+                        handle_get_stack_usage(
+                            G_io_apdu_buffer[OFFSET_P1], 
+                            G_io_apdu_buffer[OFFSET_P2],
+                            G_io_apdu_buffer + OFFSET_CDATA, 
+                            G_io_apdu_buffer[OFFSET_LC], 
+                            &flags, 
+                            &tx
+                        );
+                        break;
+
+                    case INS_GET_TRACE:
+                        // debug
+                        handle_get_trace(
+                            G_io_apdu_buffer[OFFSET_P1], 
+                            G_io_apdu_buffer[OFFSET_P2],
+                            G_io_apdu_buffer + OFFSET_CDATA, 
+                            G_io_apdu_buffer[OFFSET_LC], 
+                            &flags, 
+                            &tx
+                        );
+                        break;
+#endif // HAVE_DEBUG_INS
+
                     default: 
                         THROW(EXCEPTION_UNKNOWN_INS);
                 }
+
+                DEBUG_TRACE(TRACE_HANDLER_RETURNED);
             }
             CATCH(EXCEPTION_IO_RESET) {
                 THROW(EXCEPTION_IO_RESET);
@@ -102,6 +155,8 @@ void app_main() {
 
                 G_io_apdu_buffer[tx++] = sw >> 8;
                 G_io_apdu_buffer[tx++] = sw & 0xff;
+
+                stats_end_command(sw);
             }
             FINALLY {
                 // explicitly do nothing
@@ -124,6 +179,8 @@ void app_exit(void) {
     END_TRY_L(exit);
 }
 
+// The host build (host/) boots through host_run instead
+#ifndef HOST_BUILD
 __attribute__((section(".boot"))) int main() {
     // exit critical section (ledger magic)
     __asm volatile("cpsie i");
@@ -131,6 +188,10 @@ __attribute__((section(".boot"))) int main() {
     // go with the overflow
     debug_init_stack_canary();
 
+#ifdef HAVE_DEBUG_INS
+    debug_paint_stack();
+#endif // HAVE_DEBUG_INS
+
     os_boot();
 
     for (;;) {
@@ -180,3 +241,4 @@ __attribute__((section(".boot"))) int main() {
 
     return 0;
 }
+#endif // HOST_BUILD
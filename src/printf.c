@@ -30,6 +30,10 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+// The app formats everything through the typed hedera_format_* functions,
+// so this is only compiled into debug builds (DEBUG=1 defines HAVE_PRINTF)
+#ifdef HAVE_PRINTF
+
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -912,3 +916,5 @@ int hedera_fctprintf(void (*out)(char character, void* arg), void* arg, const ch
   va_end(va);
   return ret;
 }
+
+#endif // HAVE_PRINTF
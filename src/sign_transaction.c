@@ -1,10 +1,10 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include <pb.h>
 #include <pb_decode.h>
 
-#include "printf.h"
 #include "globals.h"
 #include "debug.h"
 #include "errors.h"
@@ -15,36 +15,120 @@
 #include "utils.h"
 #include "ui.h"
 #include "sign_transaction.h"
+#include "context.h"
+
+// This command's context lives in the shared command arena
+#define ctx (G_command_context.sign_transaction)
+
+// Review order for each TransactionType, indexed by type and ending at
+// Deny. Both the Nano S navigation and the Nano X flow follow it, so
+// adding a transaction type only needs a new row here.
+static const uint8_t review_steps[][Deny] = {
+    [Verify] = { Summary, Senders, Confirm, Deny },
+    [Create] = { Summary, Operator, Amount, Fee, Memo, Confirm, Deny },
+    [Transfer] = {
+        Summary, Operator, Senders, Recipients, Amount, Fee, Memo, Confirm, Deny
+    },
+    [ScheduledCreate] = {
+        Summary, Operator, Amount, Fee, Memo,
+        ScheduledFee, ScheduledMemo, ScheduleMemo, Confirm, Deny
+    },
+    [ScheduledTransfer] = {
+        Summary, Operator, Senders, Recipients, Amount, Fee, Memo,
+        ScheduledFee, ScheduledMemo, ScheduleMemo, Confirm, Deny
+    }
+};
 
-#if defined(TARGET_NANOS)
-static struct sign_tx_context_t {
-    // ui common
-    uint32_t key_index;
-    uint8_t transfer_to_index;
-    uint8_t transfer_from_index;
-
-    // Transaction Summary
-    char summary_line_1[DISPLAY_SIZE + 1];
-    char summary_line_2[DISPLAY_SIZE + 1];
-    char title[DISPLAY_SIZE + 1];
-    
-    // Account ID: uint64_t.uint64_t.uint64_t
-    // Most other entities are shorter
-    char full[ACCOUNT_ID_SIZE + 1];
-    char partial[DISPLAY_SIZE + 1];
-    
-    // Steps correspond to parts of the transaction proto
-    // type is set based on proto
-    enum TransactionStep step;
-    enum TransactionType type;
-
-    uint8_t display_index;  // 1 -> Number Screens
-    uint8_t display_count;  // Number Screens
-
-    // Parsed transaction
-    HederaTransactionBody transaction;
-} ctx;
+// The memo a memo step shows, with its title; NULL for other steps. With
+// " (n/m)" a title fits the 17 characters of a Nano S line, so the
+// scheduled body's fee and memo are "Inner" ones.
+static const char* memo_of(enum TransactionStep step, const char** title) {
+    switch (step) {
+        case Memo:
+            *title = "Memo";
+            return ctx.transaction.memo;
+        case ScheduledMemo:
+            *title = "Inner Memo";
+            return ctx.schedule.memo;
+        case ScheduleMemo:
+            *title = "Sched. Memo";
+            return ctx.schedule.schedule_memo;
+        default:
+            return NULL;
+    }
+}
+
+// Renders the value of a field step into dst and sets its title. The
+// Nano S renders every field of review_steps[ctx.type] before the review
+// starts (format_fields), the Nano X each one as its flow step is entered
+// (load_field).
+static size_t format_field(
+    enum TransactionStep step,
+    char* dst,
+    size_t size,
+    const char** title
+) {
+    const HederaTransferList* transfers =
+        &ctx.transaction.data.cryptoTransfer.transfers;
+    const HederaAccountID* account;
+    const char* memo;
+    uint64_t tinybar;
+
+    switch (step) {
+        case Operator:
+            *title = "Operator";
+            account = &ctx.transaction.transactionID.accountID;
+            break;
+        case Senders:
+            if (ctx.type == Verify) {
+                *title = "Account";
+                account = &transfers->accountAmounts[0].accountID;
+            } else {
+                *title = "Sender";
+                account = &transfers->accountAmounts[ctx.transfer_from_index].accountID;
+            }
+            break;
+        case Recipients:
+            *title = "Recipient";
+            account = &transfers->accountAmounts[ctx.transfer_to_index].accountID;
+            break;
+        case Amount:
+            if (ctx.type == Create || ctx.type == ScheduledCreate) {
+                *title = "Balance";
+                tinybar = ctx.transaction.data.cryptoCreateAccount.initialBalance;
+            } else {
+                *title = "Amount";
+                tinybar = transfers->accountAmounts[ctx.transfer_to_index].amount;
+            }
+            return hedera_format_hbar(dst, size, tinybar);
+        case Fee:
+            *title = "Max Fee";
+            return hedera_format_hbar(dst, size, ctx.transaction.transactionFee);
+        case ScheduledFee:
+            *title = "Inner Fee";
+            return hedera_format_hbar(dst, size, ctx.schedule.fee);
+        case Memo:
+        case ScheduledMemo:
+        case ScheduleMemo:
+            // Every memo has been bounded and terminated by its decoder
+            memo = memo_of(step, title);
+            strncpy(dst, memo, size - 1);
+            dst[size - 1] = '\0';
+            return strlen(dst);
+        default:
+            THROW(EXCEPTION_MALFORMED_APDU);
+    }
 
+    return hedera_format_entity_id(
+        dst,
+        size,
+        account->shardNum,
+        account->realmNum,
+        account->accountNum
+    );
+}
+
+#if defined(TARGET_NANOS)
 // UI Definition for Nano S
 // Step 1: Transaction Summary
 static const bagl_element_t ui_tx_summary_step[] = {
@@ -59,7 +143,8 @@ static const bagl_element_t ui_tx_summary_step[] = {
     UI_TEXT(LINE_2_ID, 0, 26, 128, ctx.summary_line_2)
 };
 
-// Step 2 - 7: Operator, Senders, Recipients, Amount, Fee, Memo
+// Step 2 - 10: Operator, Senders, Recipients, Amount, Fee, Memo,
+// Scheduled Fee, Scheduled Memo, Schedule Memo
 static const bagl_element_t ui_tx_intermediate_step[] = {
     UI_BACKGROUND(),
     UI_ICON_LEFT(LEFT_ICON_ID, BAGL_GLYPH_ICON_LEFT),
@@ -73,7 +158,13 @@ static const bagl_element_t ui_tx_intermediate_step[] = {
     UI_TEXT(LINE_2_ID, 0, 26, 128, ctx.partial)
 };
 
-// Step 8: Confirm
+// Both lines change on every page, as the title carries the page counter,
+// so paging redraws the whole screen with UX_REDISPLAY()
+
+// Repeats of a held button before it moves by whole fields
+#define FAST_FIELD_REPEATS 8
+
+// Step 11: Confirm
 static const bagl_element_t ui_tx_confirm_step[] = {
     UI_BACKGROUND(),
     UI_ICON_LEFT(LEFT_ICON_ID, BAGL_GLYPH_ICON_LEFT),
@@ -87,7 +178,7 @@ static const bagl_element_t ui_tx_confirm_step[] = {
     UI_ICON(LINE_2_ID, 0, 24, 128, BAGL_GLYPH_ICON_CHECK)
 };
 
-// Step 9: Deny
+// Step 12: Deny
 static const bagl_element_t ui_tx_deny_step[] = {
     UI_BACKGROUND(),
     UI_ICON_LEFT(LEFT_ICON_ID, BAGL_GLYPH_ICON_LEFT),
@@ -100,269 +191,219 @@ static const bagl_element_t ui_tx_deny_step[] = {
     UI_ICON(LINE_2_ID, 0, 24, 128, BAGL_GLYPH_ICON_CROSS)
 };
 
-// Step 1: Transaction Summary
-unsigned int ui_tx_summary_step_button(
-    unsigned int button_mask,
-    unsigned int button_mask_counter
-) {
-    switch(button_mask) {
-        case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
-            if (ctx.type == Verify) {
-                ctx.step = Senders;
-                ctx.display_index = 1;
-                reformat_senders();
-            } else {
-                ctx.step = Operator;
-                ctx.display_index = 1;
-                reformat_operator();
-            }
-            UX_DISPLAY(ui_tx_intermediate_step, NULL);
-            break;
+static bool is_field_step(enum TransactionStep step) {
+    return step >= Operator && step <= ScheduleMemo;
+}
+
+void format_fields() {
+    const uint8_t* steps = review_steps[ctx.type];
+
+    ctx.values_length = 0;
+
+    for (uint8_t i = 0; steps[i] != Deny; i++) {
+        enum TransactionStep step = steps[i];
+        struct review_field_t* field;
+        char* text = ctx.values + ctx.values_length;
+        const char* memo;
+
+        if (!is_field_step(step)) {
+            continue;
+        }
+
+        field = &ctx.fields[step - Operator];
+
+        memo = memo_of(step, &field->title);
+        if (memo != NULL) {
+            // Paged in place rather than copied into `values`
+            field->text = memo;
+            field->length = strlen(memo);
+            continue;
+        }
+
+        field->text = text;
+        field->length = format_field(
+            step,
+            text,
+            sizeof(ctx.values) - ctx.values_length,
+            &field->title
+        );
+        ctx.values_length += field->length;
+    }
+}
+
+// Position of `step` in the current review
+static uint8_t step_index_of(enum TransactionStep step) {
+    uint8_t index = 0;
+
+    while (review_steps[ctx.type][index] != step) {
+        index++;
     }
 
-    return 0;
+    return index;
 }
 
-void handle_intermediate_left_press() {
-    // Navigate Left (scroll or return to previous step)
+// Moves to the step at `index` of the current review, on its first page
+void goto_step(uint8_t index) {
+    bool was_field = is_field_step(ctx.step);
+
+    ctx.step_index = index;
+    ctx.step = review_steps[ctx.type][index];
+    ctx.display_index = 1;
+
     switch (ctx.step) {
-        case Operator: {
-            if (first_screen()) {  // Return to Summary
-                ctx.step = Summary;
-                ctx.display_index = 1;
-                UX_DISPLAY(ui_tx_summary_step, NULL);
-            } else {  // Scroll Left
-                ctx.display_index--;
-                reformat_operator();
+        case Summary:
+            UX_DISPLAY(ui_tx_summary_step, NULL);
+            break;
+        case Confirm:
+            UX_DISPLAY(ui_tx_confirm_step, NULL);
+            break;
+        case Deny:
+            UX_DISPLAY(ui_tx_deny_step, NULL);
+            break;
+        default:
+            ctx.display_count = num_screens(ctx.fields[ctx.step - Operator].length);
+            reformat_page();
+            if (was_field) {
                 UX_REDISPLAY();
+            } else {
+                UX_DISPLAY(ui_tx_intermediate_step, NULL);
             }
-        } break;
-        case Senders: {
-            if (first_screen()) {  // Return to Operator
-                if (ctx.type == Verify) {
-                    ctx.step = Summary;
-                    ctx.display_index = 1;
-                    UX_DISPLAY(ui_tx_summary_step, NULL);
-                } else {
-                    ctx.step = Operator;
-                    ctx.display_index = 1;
-                    reformat_operator();
-                }
-            } else {  // Scroll Left
-                ctx.display_index--;
-                reformat_senders();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Recipients: {
-            if (first_screen()) {  // Return to Senders
-                ctx.step = Senders;
-                ctx.display_index = 1;
-                reformat_senders();
-            } else {  // Scroll Left
-                ctx.display_index--;
-                reformat_recipients();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Amount: {
-            if (first_screen()) {
-                if (ctx.type == Create) {  // Return to Operator
-                    ctx.step = Operator;
-                    ctx.display_index = 1;
-                    reformat_operator();
-                } else if (ctx.type == Transfer) {  // Return to Recipients
-                    ctx.step = Recipients;
-                    ctx.display_index = 1;
-                    reformat_recipients();
-                }
-            } else {  // Scroll left
-                ctx.display_index--;
-                reformat_amount();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Fee: {
-            if (first_screen()) {  // Return to Amount
-                ctx.step = Amount;
-                ctx.display_index = 1;
-                reformat_amount();
-            } else {  // Scroll left
-                ctx.display_index--;
-                reformat_fee();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Memo: {
-            if (first_screen()) {  // Return to Fee
-                ctx.step = Fee;
-                ctx.display_index = 1;
-                reformat_fee();
-            } else {  // Scroll Left
-                ctx.display_index--;
-                reformat_memo();
-            }
-            UX_REDISPLAY();
-        } break;
+            break;
+    }
+}
+
+void review_left_press() {
+    // Navigate Left (scroll or return to previous step)
+    if (is_field_step(ctx.step) && !first_screen()) {
+        ctx.display_index--;
+        reformat_page();
+        UX_REDISPLAY();
+    } else if (ctx.step != Summary) {
+        goto_step(ctx.step_index - 1);
     }
 }
 
-void handle_intermediate_right_press() {
+void review_right_press() {
     // Navigate Right (scroll or continue to next step)
-    switch (ctx.step) {
-        case Operator: {
-            if (last_screen()) {
-                if (ctx.type == Create) {  // Continue to Amount
-                    ctx.step = Amount;
-                    ctx.display_index = 1;
-                    reformat_amount();
-                } else {  // Continue to Senders
-                    ctx.step = Senders;
-                    ctx.display_index = 1;
-                    reformat_senders();
-                }
-            } else {  // Scroll Right
-                ctx.display_index++;
-                reformat_operator();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Senders: {
-            if (last_screen()) {
-                if (ctx.type == Verify) {  // Continue to Confirm
-                    ctx.step = Confirm;
-                    UX_DISPLAY(ui_tx_confirm_step, NULL);
-                } else {  // Continue to Recipients
-                    ctx.step = Recipients;
-                    ctx.display_index = 1;
-                    reformat_recipients();
-                }
-            } else {  // Scroll Right
-                ctx.display_index++;
-                reformat_senders();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Recipients: {
-            if (last_screen()) {  // Continue to Amount
-                ctx.step = Amount;
-                ctx.display_index = 1;
-                reformat_amount();
-            } else {  // Scroll Right
-                ctx.display_index++;
-                reformat_recipients();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Amount: {
-            if (last_screen()) {  // Continue to Fee
-                ctx.step = Fee;
-                ctx.display_index = 1;
-                reformat_fee();
-            } else {  // Scroll Right
-                ctx.display_index++;
-                reformat_amount();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Fee: {
-            if (last_screen()) {  // Continue to Memo
-                ctx.step = Memo;
-                ctx.display_index = 1;
-                reformat_memo();
-            } else {  // Scroll Right
-                ctx.display_index++;
-                reformat_fee();
-            }
-            UX_REDISPLAY();
-        } break;
-        case Memo: {
-            if (last_screen()) {  // Continue to Confirm
-                ctx.step = Confirm;
-                ctx.display_index = 1;
-                UX_DISPLAY(ui_tx_confirm_step, NULL);
-            } else {  // Scroll Right
-                ctx.display_index++;
-                reformat_memo();
-                UX_REDISPLAY();
-            }
-        } break;
+    if (is_field_step(ctx.step) && !last_screen()) {
+        ctx.display_index++;
+        reformat_page();
+        UX_REDISPLAY();
+    } else if (ctx.step != Deny) {
+        goto_step(ctx.step_index + 1);
     }
 }
 
-// Step 2 - 7: Operator, Senders, Recipients, Amount, Fee, Memo
-unsigned int ui_tx_intermediate_step_button(
-    unsigned int button_mask,
-    unsigned int button_mask_counter
-) {
-    switch(button_mask) {
-        case BUTTON_EVT_RELEASED | BUTTON_LEFT:
-            handle_intermediate_left_press();
+void review_both_press() {
+    switch (ctx.step) {
+        case Summary:
             break;
-        case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
-            handle_intermediate_right_press();
+        case Confirm:
+            // Exchange Signature (OK)
+            io_exchange_with_code(EXCEPTION_OK, 64);
+            ui_idle();
             break;
-        case BUTTON_EVT_RELEASED | BUTTON_LEFT | BUTTON_RIGHT:
+        case Deny:
+            // Reject
+            ctx.step = Unknown;
+            io_exchange_with_code(EXCEPTION_USER_REJECTED, 0);
+            ui_idle();
+            break;
+        default:
             // Skip to confirm screen
-            ctx.step = Confirm;
-            UX_DISPLAY(ui_tx_confirm_step, NULL);
+            goto_step(step_index_of(Confirm));
             break;
     }
+}
 
-    return 0;
+// A held button pages through the current field, then moves a whole field
+// per repeat once held for FAST_FIELD_REPEATS. Repeats never leave the
+// field steps, so Summary, Confirm and Deny still need a deliberate press.
+void review_fast_press(int8_t direction) {
+    uint8_t next = ctx.step_index + direction;
+    bool edge = direction < 0 ? first_screen() : last_screen();
+    bool whole_field;
+
+    if (!is_field_step(ctx.step)) return;
+
+    if (ctx.fast_repeats < FAST_FIELD_REPEATS) ctx.fast_repeats++;
+    whole_field = ctx.fast_repeats == FAST_FIELD_REPEATS;
+
+    if ((whole_field || edge) && is_field_step(review_steps[ctx.type][next])) {
+        goto_step(next);
+    } else if (!edge) {
+        if (direction < 0) {
+            review_left_press();
+        } else {
+            review_right_press();
+        }
+    }
 }
 
-unsigned int ui_tx_confirm_step_button(
-    unsigned int button_mask,
-    unsigned int button_mask_counter
-) {
+// Every review screen shares one navigator
+unsigned int review_button(unsigned int button_mask, unsigned int button_mask_counter) {
+    if (!(button_mask & (BUTTON_EVT_FAST | BUTTON_EVT_RELEASED))) {
+        // A press starts with a count of 0; repeats while held count up.
+        // The release ending a fast hold also comes without flags, as the
+        // SDK drops BUTTON_EVT_RELEASED, so it is never a press of its own.
+        if (button_mask_counter == 0) {
+            ctx.fast_repeats = 0;
+        }
+        return 0;
+    }
+
     switch(button_mask) {
+        case BUTTON_EVT_FAST | BUTTON_LEFT:
+            review_fast_press(-1);
+            break;
+        case BUTTON_EVT_FAST | BUTTON_RIGHT:
+            review_fast_press(1);
+            break;
         case BUTTON_EVT_RELEASED | BUTTON_LEFT:
-            if (ctx.type == Verify) {  // Return to Senders
-                ctx.step = Senders;
-                ctx.display_index = 1;
-                reformat_senders();
-            } else { // Return to Memo
-                ctx.step = Memo;
-                ctx.display_index = 1;
-                reformat_memo();
-            }
-            UX_DISPLAY(ui_tx_intermediate_step, NULL);
+            review_left_press();
             break;
         case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
-            // Continue to Deny
-            ctx.step = Deny;
-            UX_DISPLAY(ui_tx_deny_step, NULL);
+            review_right_press();
             break;
         case BUTTON_EVT_RELEASED | BUTTON_LEFT | BUTTON_RIGHT:
-            // Exchange Signature (OK)
-            io_exchange_with_code(EXCEPTION_OK, 64);
-            ui_idle();
+            review_both_press();
             break;
     }
 
     return 0;
 }
 
-unsigned int ui_tx_deny_step_button(
+// Step 1: Transaction Summary
+unsigned int ui_tx_summary_step_button(
     unsigned int button_mask,
     unsigned int button_mask_counter
 ) {
-    switch(button_mask) {
-        case BUTTON_EVT_RELEASED | BUTTON_LEFT:
-            // Return to Confirm
-            ctx.step = Confirm;
-            UX_DISPLAY(ui_tx_confirm_step, NULL);
-            break;
-        case BUTTON_EVT_RELEASED | BUTTON_LEFT | BUTTON_RIGHT:
-            // Reject
-            ctx.step = Unknown;
-            io_exchange_with_code(EXCEPTION_USER_REJECTED, 0);
-            ui_idle();
-            break;
-    }
+    return review_button(button_mask, button_mask_counter);
+}
 
-    return 0;
+// Step 2 - 10: Operator, Senders, Recipients, Amount, Fee, Memo,
+// Scheduled Fee, Scheduled Memo, Schedule Memo
+unsigned int ui_tx_intermediate_step_button(
+    unsigned int button_mask,
+    unsigned int button_mask_counter
+) {
+    return review_button(button_mask, button_mask_counter);
+}
+
+// Step 11: Confirm
+unsigned int ui_tx_confirm_step_button(
+    unsigned int button_mask,
+    unsigned int button_mask_counter
+) {
+    return review_button(button_mask, button_mask_counter);
+}
+
+// Step 12: Deny
+unsigned int ui_tx_deny_step_button(
+    unsigned int button_mask,
+    unsigned int button_mask_counter
+) {
+    return review_button(button_mask, button_mask_counter);
 }
 
 uint8_t num_screens(size_t length) {
@@ -373,20 +414,6 @@ uint8_t num_screens(size_t length) {
     return screens;
 }
 
-void count_screens() {
-    ctx.display_count = num_screens(strlen(ctx.full));
-}
-
-void shift_display() {
-    // Slide window (partial) along full entity (full) by DISPLAY_SIZE chars
-    memset(ctx.partial, '\0', DISPLAY_SIZE + 1);
-    memmove(
-        ctx.partial,
-        ctx.full + (DISPLAY_SIZE * (ctx.display_index - 1)),
-        DISPLAY_SIZE
-    );
-}
-
 bool last_screen() {
     return ctx.display_index == ctx.display_count;
 }
@@ -395,266 +422,44 @@ bool first_screen() {
     return ctx.display_index == 1;
 }
 
-void reformat_operator() {
-    hedera_snprintf(
-        ctx.full,
-        ACCOUNT_ID_SIZE,
-        "%llu.%llu.%llu",
-        ctx.transaction.transactionID.accountID.shardNum,
-        ctx.transaction.transactionID.accountID.realmNum,
-        ctx.transaction.transactionID.accountID.accountNum
-    );
-
-    count_screens();
-    
-    hedera_snprintf(
+void reformat_title(const char* title) {
+    hedera_format_counter_title(
         ctx.title,
         DISPLAY_SIZE,
-        "Operator (%u/%u)",
+        title,
         ctx.display_index,
         ctx.display_count
     );
-
-    shift_display();
 }
 
-void reformat_accounts(char* title_part, uint8_t transfer_index) {
-    hedera_snprintf(
-        ctx.full,
-        ACCOUNT_ID_SIZE,
-        "%llu.%llu.%llu",
-        ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[transfer_index].accountID.shardNum,
-        ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[transfer_index].accountID.realmNum,
-        ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[transfer_index].accountID.accountNum
-    );
-
-    count_screens();
-
-    hedera_snprintf(
-        ctx.title,
-        DISPLAY_SIZE,
-        "%s (%u/%u)",
-        title_part,
-        ctx.display_index,
-        ctx.display_count
-    );
-}
+void reformat_page() {
+    // Slide window (partial) along the current field by DISPLAY_SIZE chars
+    const struct review_field_t* field = &ctx.fields[ctx.step - Operator];
+    size_t offset = DISPLAY_SIZE * (ctx.display_index - 1);
+    size_t length = field->length - offset;
 
-void reformat_senders() {
-    if (ctx.type == Verify) {
-        reformat_accounts("Account", 0);
-    } else {
-        reformat_accounts("Sender", ctx.transfer_from_index);
+    if (length > DISPLAY_SIZE) {
+        length = DISPLAY_SIZE;
     }
 
-    shift_display();
-}
+    memmove(ctx.partial, field->text + offset, length);
+    ctx.partial[length] = '\0';
 
-void reformat_recipients() {
-    reformat_accounts("Recipient", ctx.transfer_to_index);
-    shift_display();
+    reformat_title(field->title);
 }
 
-void reformat_amount() {
-    switch (ctx.type) {
-        case Create:
-            hedera_snprintf(
-                ctx.full,
-                DISPLAY_SIZE * 3,
-                "%s hbar",
-                hedera_format_tinybar(ctx.transaction.data.cryptoCreateAccount.initialBalance)
-            );
-            break;
-        case Transfer:
-            hedera_snprintf(
-                ctx.full,
-                DISPLAY_SIZE * 3,
-                "%s hbar",
-                hedera_format_tinybar(ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_to_index].amount)
-            );
-            break;
-    }
+void start_review() {
+    format_fields();
+    DEBUG_TRACE(TRACE_TX_FORMATTED);
 
-    count_screens();
-
-    hedera_snprintf(
-        ctx.title,
-        DISPLAY_SIZE,
-        "%s (%u/%u)",
-        ctx.type == Create ? "Balance" : "Amount",
-        ctx.display_index,
-        ctx.display_count
-    );
-
-    shift_display();
-}
-
-void reformat_fee() {
-    hedera_snprintf(
-        ctx.full,
-        DISPLAY_SIZE * 3,
-        "%s hbar",
-        hedera_format_tinybar(ctx.transaction.transactionFee)
-    );
-
-    count_screens();
-
-    hedera_snprintf(
-        ctx.title,
-        DISPLAY_SIZE,
-        "Max Fee (%u/%u)",
-        ctx.display_index,
-        ctx.display_count
-    );
-
-    shift_display();
-}
-
-void reformat_memo() {
-    hedera_snprintf(
-        ctx.full,
-        MAX_MEMO_SIZE,
-        "%s",
-        ctx.transaction.memo
-    );
-
-    if (strlen(ctx.full) > MAX_MEMO_SIZE) {
-        // :grimacing:
-        THROW(EXCEPTION_MALFORMED_APDU); 
-    }
-
-    count_screens();
-
-    hedera_snprintf(
-        ctx.title,
-        DISPLAY_SIZE,
-        "Memo (%u/%u)",
-        ctx.display_index,
-        ctx.display_count
-    );
-
-    shift_display();
-}
-
-void handle_transaction_body() {
-    memset(ctx.summary_line_1, '\0', DISPLAY_SIZE + 1);
-    memset(ctx.summary_line_2, '\0', DISPLAY_SIZE + 1);
-    memset(ctx.full, '\0', ACCOUNT_ID_SIZE + 1);
-    memset(ctx.partial, '\0', DISPLAY_SIZE + 1);
-
-    // Step 1, Unknown Type, Screen 1 of 1
+    ctx.fast_repeats = 0;
     ctx.step = Summary;
-    ctx.type = Unknown;
-    ctx.display_index = 1;
-    ctx.display_count = 1;
-
-    // <Do Action> 
-    // with Key #X?
-    hedera_snprintf(
-        ctx.summary_line_2,
-        DISPLAY_SIZE,
-        "with Key #%u?",
-        ctx.key_index
-    );
-
-    // Handle parsed protobuf message of transaction body
-    switch (ctx.transaction.which_data) {
-        case HederaTransactionBody_cryptoCreateAccount_tag:
-            // Create Account Transaction
-            ctx.type = Create;
-            hedera_snprintf(
-                ctx.summary_line_1,
-                DISPLAY_SIZE,
-                "Create Account"
-            );
-            break;
-
-        case HederaTransactionBody_cryptoTransfer_tag: {
-            // Transfer Transaction
-            if (ctx.transaction.data.cryptoTransfer.transfers.accountAmounts_count > 2) {
-                // Unsupported (number of accounts > 2)
-                THROW(EXCEPTION_MALFORMED_APDU);
-            }
-
-            if ( // Only 1 Account (Sender), Fee 1 Tinybar, and Value 0 Tinybar
-                ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].amount == 0 && 
-                ctx.transaction.data.cryptoTransfer.transfers.accountAmounts_count == 1 &&
-                ctx.transaction.transactionFee == 1) {
-                    // Verify Account Transaction
-                    ctx.type = Verify;
-                    hedera_snprintf(
-                        ctx.summary_line_1,
-                        DISPLAY_SIZE,
-                        "Verify Account"
-                    );
-
-            } else { // Number of Accounts == 2
-                // Some other Transfer Transaction
-                // Determine Sender based on amount
-                ctx.type = Transfer;
-
-                hedera_snprintf(
-                    ctx.summary_line_1,
-                    DISPLAY_SIZE,
-                    "Transfer"
-                );
-
-                ctx.transfer_to_index = 1;
-                ctx.transfer_from_index = 0;
-                if (ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].amount > 0) {
-                    ctx.transfer_to_index = 0;
-                    ctx.transfer_from_index = 1;
-                }
-            }
-        } break;
-
-        default:
-            // Unsupported
-            THROW(EXCEPTION_MALFORMED_APDU);
-    }
-
-    UX_DISPLAY(ui_tx_summary_step, NULL);
+    goto_step(0);
+    DEBUG_TRACE(TRACE_UI_DISPLAYED);
 }
 
 #elif defined(TARGET_NANOX) || defined(TARGET_NANOS2)
 
-static struct sign_tx_context_t {
-    // ui common
-    uint32_t key_index;
-    uint8_t transfer_from_index;
-    uint8_t transfer_to_index;
-
-    // Transaction Summary
-    char summary_line_1[DISPLAY_SIZE + 1];
-    char summary_line_2[DISPLAY_SIZE + 1];
-    char senders_title[DISPLAY_SIZE + 1];
-    char amount_title[DISPLAY_SIZE + 1];
-    char partial[DISPLAY_SIZE + 1];
-
-    enum TransactionType type;
-
-    // Transaction Operator
-    char operator[DISPLAY_SIZE * 2 + 1];
-
-    // Transaction Senders
-    char senders[DISPLAY_SIZE * 2 + 1];
-
-    // Transaction Recipients
-    char recipients[DISPLAY_SIZE * 2 + 1];
-
-    // Transaction Amount
-    char amount[DISPLAY_SIZE * 2 + 1];
-    
-    // Transaction Fee
-    char fee[DISPLAY_SIZE * 2 + 1];
-
-    // Transaction Memo
-    char memo[MAX_MEMO_SIZE + 1];
-
-    // Parsed transaction
-    HederaTransactionBody transaction;
-} ctx;
-
 // UI Definition for Nano X
 
 // Confirm Callback
@@ -671,6 +476,17 @@ unsigned int io_seproxyhal_tx_reject(const bagl_element_t* e) {
     return 0;
 }
 
+// Renders a field into the shared title/value buffers when its step is
+// entered, so nothing is formatted for steps the flow never shows
+void load_field(enum TransactionStep step) {
+    const char* title;
+
+    format_field(step, ctx.value, sizeof(ctx.value), &title);
+
+    strncpy(ctx.title, title, DISPLAY_SIZE);
+    ctx.title[DISPLAY_SIZE] = '\0';
+}
+
 UX_STEP_NOCB(
     ux_tx_flow_1_step,
     bnn,
@@ -681,62 +497,98 @@ UX_STEP_NOCB(
     }
 );
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_2_step,
     bnnn_paging,
+    load_field(Operator),
     {
-        .title = "Operator",
-        .text = (char*) ctx.operator
+        .title = ctx.title,
+        .text = ctx.value
     }
 );
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_3_step,
     bnnn_paging,
+    load_field(Senders),
     {
-        .title = (char*) ctx.senders_title,
-        .text = (char*) ctx.senders
+        .title = ctx.title,
+        .text = ctx.value
     }
 );
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_4_step,
     bnnn_paging,
+    load_field(Recipients),
     {
-        .title = "Recipient",
-        .text = (char*) ctx.recipients
+        .title = ctx.title,
+        .text = ctx.value
     }
 );
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_5_step,
     bnnn_paging,
+    load_field(Amount),
     {
-        .title = (char*) ctx.amount_title,
-        .text = (char*) ctx.amount
+        .title = ctx.title,
+        .text = ctx.value
     }
 );
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_6_step,
     bnnn_paging,
+    load_field(Fee),
     {
-        .title = "Max Fee",
-        .text = (char*) ctx.fee
+        .title = ctx.title,
+        .text = ctx.value
     }
 );
 
-UX_STEP_NOCB(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_7_step,
     bnnn_paging,
+    load_field(Memo),
     {
-        .title = "Memo",
-        .text = (char*) ctx.memo
+        .title = ctx.title,
+        .text = ctx.value
     }
 );
 
-UX_STEP_VALID(
+UX_STEP_NOCB_INIT(
     ux_tx_flow_8_step,
+    bnnn_paging,
+    load_field(ScheduledFee),
+    {
+        .title = ctx.title,
+        .text = ctx.value
+    }
+);
+
+UX_STEP_NOCB_INIT(
+    ux_tx_flow_9_step,
+    bnnn_paging,
+    load_field(ScheduledMemo),
+    {
+        .title = ctx.title,
+        .text = ctx.value
+    }
+);
+
+UX_STEP_NOCB_INIT(
+    ux_tx_flow_10_step,
+    bnnn_paging,
+    load_field(ScheduleMemo),
+    {
+        .title = ctx.title,
+        .text = ctx.value
+    }
+);
+
+UX_STEP_VALID(
+    ux_tx_flow_11_step,
     pb,
     io_seproxyhal_tx_approve(NULL),
     {
@@ -746,7 +598,7 @@ UX_STEP_VALID(
 );
 
 UX_STEP_VALID(
-    ux_tx_flow_9_step,
+    ux_tx_flow_12_step,
     pb,
     io_seproxyhal_tx_reject(NULL),
     {
@@ -755,115 +607,67 @@ UX_STEP_VALID(
     }
 );
 
-// Transfer UX Flow
-UX_DEF(
-    ux_transfer_flow,
-    &ux_tx_flow_1_step,
-    &ux_tx_flow_2_step,
-    &ux_tx_flow_3_step,
-    &ux_tx_flow_4_step,
-    &ux_tx_flow_5_step,
-    &ux_tx_flow_6_step,
-    &ux_tx_flow_7_step,
-    &ux_tx_flow_8_step,
-    &ux_tx_flow_9_step
-);
+// Flow step showing each TransactionStep
+static const ux_flow_step_t* const ux_tx_steps[] = {
+    [Summary] = &ux_tx_flow_1_step,
+    [Operator] = &ux_tx_flow_2_step,
+    [Senders] = &ux_tx_flow_3_step,
+    [Recipients] = &ux_tx_flow_4_step,
+    [Amount] = &ux_tx_flow_5_step,
+    [Fee] = &ux_tx_flow_6_step,
+    [Memo] = &ux_tx_flow_7_step,
+    [ScheduledFee] = &ux_tx_flow_8_step,
+    [ScheduledMemo] = &ux_tx_flow_9_step,
+    [ScheduleMemo] = &ux_tx_flow_10_step,
+    [Confirm] = &ux_tx_flow_11_step,
+    [Deny] = &ux_tx_flow_12_step
+};
 
-// Create UX Flow
-UX_DEF(
-    ux_create_flow,
-    &ux_tx_flow_1_step,
-    &ux_tx_flow_2_step,
-    &ux_tx_flow_5_step,
-    &ux_tx_flow_6_step,
-    &ux_tx_flow_7_step,
-    &ux_tx_flow_8_step,
-    &ux_tx_flow_9_step
-);
+// review_steps[ctx.type] as flow steps, then FLOW_END_STEP
+static const ux_flow_step_t* ux_review_flow[Deny + 1];
 
-// Verify UX Flow
-UX_DEF(
-    ux_verify_flow,
-    &ux_tx_flow_1_step,
-    &ux_tx_flow_3_step,
-    &ux_tx_flow_8_step,
-    &ux_tx_flow_9_step
-);
+void start_review() {
+    const uint8_t* steps = review_steps[ctx.type];
+    uint8_t i = 0;
 
-void handle_transaction_body() {
+    do {
+        ux_review_flow[i] = ux_tx_steps[steps[i]];
+    } while (steps[i++] != Deny);
+
+    ux_review_flow[i] = FLOW_END_STEP;
+
+    ux_flow_init(0, ux_review_flow, NULL);
+    DEBUG_TRACE(TRACE_UI_DISPLAYED);
+}
+
+#endif // TARGET
+
+// Sets the type and summary lines of the decoded transaction, throwing on
+// bodies the app cannot review
+void classify_transaction() {
     memset(ctx.summary_line_1, '\0', DISPLAY_SIZE + 1);
     memset(ctx.summary_line_2, '\0', DISPLAY_SIZE + 1);
-    memset(ctx.amount_title, '\0', DISPLAY_SIZE + 1);
-    memset(ctx.senders_title, '\0', DISPLAY_SIZE + 1);
-    memset(ctx.operator, '\0', DISPLAY_SIZE * 2 + 1);
-    memset(ctx.senders, '\0', DISPLAY_SIZE * 2 + 1);
-    memset(ctx.recipients, '\0', DISPLAY_SIZE * 2 + 1);
-    memset(ctx.fee, '\0', DISPLAY_SIZE * 2 + 1);
-    memset(ctx.amount, '\0', DISPLAY_SIZE * 2 + 1);
-    memset(ctx.memo, '\0', MAX_MEMO_SIZE + 1);
 
     ctx.type = Unknown;
 
     // <Do Action> 
     // with Key #X?
-    hedera_snprintf(
+    hedera_format_key_label(
         ctx.summary_line_2,
         DISPLAY_SIZE,
-        "with Key #%u?",
+        "with ",
         ctx.key_index
     );
 
-    hedera_snprintf(
-        ctx.operator,
-        DISPLAY_SIZE * 2,
-        "%llu.%llu.%llu",
-        ctx.transaction.transactionID.accountID.shardNum,
-        ctx.transaction.transactionID.accountID.realmNum,
-        ctx.transaction.transactionID.accountID.accountNum
-    );
-
-    hedera_snprintf(
-        ctx.fee,
-        DISPLAY_SIZE * 2,
-        "%s hbar",
-        hedera_format_tinybar(ctx.transaction.transactionFee)
-    );
-
-    hedera_snprintf(
-        ctx.memo,
-        MAX_MEMO_SIZE,
-        "%s",
-        ctx.transaction.memo
-    );
-
-    hedera_sprintf(
-        ctx.amount_title,
-        "Amount"
-    );
-
-    hedera_sprintf(
-        ctx.senders_title,
-        "Sender"
-    );
-
     // Handle parsed protobuf message of transaction body
     switch (ctx.transaction.which_data) {
         case HederaTransactionBody_cryptoCreateAccount_tag:
-            ctx.type = Create;
             // Create Account Transaction
-            hedera_sprintf(
+            ctx.type = ctx.schedule.data ? ScheduledCreate : Create;
+            strncpy(
                 ctx.summary_line_1,
-                "Create Account"
-            );
-            hedera_sprintf(
-                ctx.amount_title,
-                "Balance"
-            );
-            hedera_snprintf(
-                ctx.amount,
-                DISPLAY_SIZE * 2,
-                "%s hbar",
-                hedera_format_tinybar(ctx.transaction.data.cryptoCreateAccount.initialBalance)
+                ctx.schedule.data ? "Schedule Account" : "Create Account",
+                DISPLAY_SIZE
             );
             break;
 
@@ -877,92 +681,220 @@ void handle_transaction_body() {
             if ( // Only 1 Account (Sender), Fee 1 Tinybar, and Value 0 Tinybar
                 ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].amount == 0 && 
                 ctx.transaction.data.cryptoTransfer.transfers.accountAmounts_count == 1 &&
-                ctx.transaction.transactionFee == 1) {
+                ctx.transaction.transactionFee == 1 &&
+                !ctx.schedule.data) {
                     // Verify Account Transaction
                     ctx.type = Verify;
-                    hedera_sprintf(
+                    strncpy(
                         ctx.summary_line_1,
-                        "Verify Account"
-                    );
-                    hedera_sprintf(
-                        ctx.senders_title,
-                        "Account"
-                    );
-                    hedera_snprintf(
-                        ctx.senders,
-                        DISPLAY_SIZE * 2,
-                        "%llu.%llu.%llu",
-                        ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].accountID.shardNum,
-                        ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].accountID.realmNum,
-                        ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].accountID.accountNum
-                    );
-                    hedera_snprintf(
-                        ctx.amount,
-                        DISPLAY_SIZE * 2,
-                        "%s hbar",
-                        hedera_format_tinybar(ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].amount)
+                        "Verify Account",
+                        DISPLAY_SIZE
                     );
 
             } else { // Number of Accounts == 2
                 // Some other Transfer Transaction
                 // Determine Sender based on amount
-                ctx.type = Transfer;
-                hedera_sprintf(
+                ctx.type = ctx.schedule.data ? ScheduledTransfer : Transfer;
+
+                strncpy(
                     ctx.summary_line_1,
-                    "Transfer"
+                    ctx.schedule.data ? "Schedule Transfer" : "Transfer",
+                    DISPLAY_SIZE
                 );
 
-                ctx.transfer_from_index = 0;
                 ctx.transfer_to_index = 1;
+                ctx.transfer_from_index = 0;
                 if (ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[0].amount > 0) {
-                    ctx.transfer_from_index = 1;
                     ctx.transfer_to_index = 0;
+                    ctx.transfer_from_index = 1;
                 }
-
-                hedera_snprintf(
-                    ctx.senders,
-                    DISPLAY_SIZE * 2,
-                    "%llu.%llu.%llu",
-                    ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_from_index].accountID.shardNum,
-                    ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_from_index].accountID.realmNum,
-                    ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_from_index].accountID.accountNum
-                );
-                hedera_snprintf(
-                    ctx.recipients,
-                    DISPLAY_SIZE * 2,
-                    "%llu.%llu.%llu",
-                    ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_to_index].accountID.shardNum,
-                    ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_to_index].accountID.realmNum,
-                    ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_to_index].accountID.accountNum
-                );
-                hedera_snprintf(
-                    ctx.amount,
-                    DISPLAY_SIZE * 2,
-                    "%s hbar",
-                    hedera_format_tinybar(ctx.transaction.data.cryptoTransfer.transfers.accountAmounts[ctx.transfer_to_index].amount)
-                );
             }
         } break;
 
         default:
             // Unsupported
             THROW(EXCEPTION_MALFORMED_APDU);
-            break;
     }
+}
 
-    switch (ctx.type) {
-        case Verify:
-            ux_flow_init(0, ux_verify_flow, NULL);
-            break;
-        case Create:
-            ux_flow_init(0, ux_create_flow, NULL);
-            break;
-        case Transfer:
-            ux_flow_init(0, ux_transfer_flow, NULL);
-            break;
+void handle_transaction_body() {
+    classify_transaction();
+    start_review();
+}
+
+// Decodes a memo into dst, which must hold it and its terminator, as
+// nanopb does for the memo of the transaction itself
+static bool decode_memo(
+    pb_istream_t* stream,
+    pb_wire_type_t wire_type,
+    char* dst,
+    size_t size
+) {
+    pb_istream_t substream;
+    size_t length;
+
+    if (wire_type != PB_WT_STRING) return false;
+    if (!pb_make_string_substream(stream, &substream)) return false;
+
+    length = substream.bytes_left;
+    bool decoded = length < size && pb_read(&substream, (pb_byte_t*) dst, length);
+
+    if (!pb_close_string_substream(stream, &substream) || !decoded) return false;
+
+    dst[length] = '\0';
+
+    return true;
+}
+
+// Decodes the body scheduled by a ScheduleCreate straight into the data
+// union of the outer transaction, reusing the Create and Transfer message
+// descriptors, so no second HederaTransactionBody is ever allocated. Its
+// fee and memo go to the schedule, to be reviewed with it.
+static bool decode_scheduled_body(
+    pb_istream_t* stream,
+    HederaTransactionBody* body,
+    /* out */ struct schedule_t* schedule
+) {
+    pb_wire_type_t wire_type;
+    uint32_t tag;
+    bool eof;
+
+    while (pb_decode_tag(stream, &wire_type, &tag, &eof)) {
+        const pb_msgdesc_t* fields;
+        void* dest;
+        pb_size_t which_data;
+
+        switch (tag) {
+            case HederaSchedulableTransactionBody_cryptoCreateAccount_tag:
+                fields = HederaCryptoCreateTransactionBody_fields;
+                dest = &body->data.cryptoCreateAccount;
+                which_data = HederaTransactionBody_cryptoCreateAccount_tag;
+                break;
+
+            case HederaSchedulableTransactionBody_cryptoTransfer_tag:
+                fields = HederaCryptoTransferTransactionBody_fields;
+                dest = &body->data.cryptoTransfer;
+                which_data = HederaTransactionBody_cryptoTransfer_tag;
+                break;
+
+            case HederaSchedulableTransactionBody_transactionFee_tag:
+                if (wire_type != PB_WT_VARINT) return false;
+                if (!pb_decode_varint(stream, &schedule->fee)) return false;
+                continue;
+
+            case HederaSchedulableTransactionBody_memo_tag:
+                if (!decode_memo(stream, wire_type, schedule->memo, sizeof(schedule->memo))) {
+                    return false;
+                }
+                continue;
+
+            default:
+                // A body the app cannot review
+                return false;
+        }
+
+        // Only one scheduled body, and it must be a message
+        if (wire_type != PB_WT_STRING || schedule->data != 0) return false;
+
+        pb_istream_t substream;
+        if (!pb_make_string_substream(stream, &substream)) return false;
+
+        bool decoded = pb_decode(&substream, fields, dest);
+
+        if (!pb_close_string_substream(stream, &substream) || !decoded) return false;
+
+        schedule->data = which_data;
+    }
+
+    return eof;
+}
+
+// nanopb callback for HederaTransactionBody.scheduleCreate
+static bool decode_schedule_create(
+    pb_istream_t* stream,
+    const pb_field_t* field,
+    void** arg
+) {
+    HederaTransactionBody* body = field->message;
+    struct schedule_t* schedule = *arg;
+    pb_wire_type_t wire_type;
+    uint32_t tag;
+    bool seen_body = false;
+    bool eof;
+
+    // A schedule must be the only body of the transaction
+    if (body->which_data != 0) return false;
+
+    // Claim the data union; an outer body decoded after this one
+    // will overwrite the tag, which handle_sign_transaction rejects
+    body->which_data = HederaTransactionBody_scheduleCreate_tag;
+
+    while (pb_decode_tag(stream, &wire_type, &tag, &eof)) {
+        if (tag == HederaScheduleCreateTransactionBody_memo_tag) {
+            if (!decode_memo(
+                stream,
+                wire_type,
+                schedule->schedule_memo,
+                sizeof(schedule->schedule_memo)
+            )) {
+                return false;
+            }
+            continue;
+        }
+
+        // The admin key and payer are not reviewed, nor is anything else
+        // the schedule holds
+        if (tag != HederaScheduleCreateTransactionBody_scheduledTransactionBody_tag) {
+            return false;
+        }
+
+        // Only one scheduled body, even an empty one
+        if (wire_type != PB_WT_STRING || seen_body) return false;
+        seen_body = true;
+
+        pb_istream_t substream;
+        if (!pb_make_string_substream(stream, &substream)) return false;
+
+        bool decoded = decode_scheduled_body(&substream, body, schedule);
+
+        if (!pb_close_string_substream(stream, &substream) || !decoded) return false;
+    }
+
+    // A schedule without a body has nothing to review, and one with a body
+    // is what lets decode_transaction notice it being replaced
+    return eof && schedule->data != 0;
+}
+
+// Decodes a TransactionBody into ctx.transaction, with a scheduled body in
+// place of its schedule
+void decode_transaction(const uint8_t* raw_transaction, size_t length) {
+    // Make in memory buffer into stream
+    pb_istream_t stream = pb_istream_from_buffer(raw_transaction, length);
+
+    // Scheduled bodies are decoded into ctx.transaction.data by callback,
+    // the rest of the schedule into ctx.schedule
+    memset(&ctx.schedule, 0, sizeof(ctx.schedule));
+    ctx.transaction.scheduleCreate.funcs.decode = decode_schedule_create;
+    ctx.transaction.scheduleCreate.arg = &ctx.schedule;
+
+    // Decode the Transaction
+    if (!pb_decode(
+        &stream,
+        HederaTransactionBody_fields, 
+        &ctx.transaction
+    )) {
+        // Oh no couldn't ...
+        THROW(EXCEPTION_MALFORMED_APDU);
+    }
+
+    if (ctx.transaction.which_data == HederaTransactionBody_scheduleCreate_tag) {
+        // Review the scheduled body in place of the schedule
+        ctx.transaction.which_data = ctx.schedule.data;
+    } else if (ctx.schedule.data != 0) {
+        // Another body followed the schedule and replaced it
+        THROW(EXCEPTION_MALFORMED_APDU);
     }
 }
-#endif
 
 // Sign Handler
 // Decodes and handles transaction message
@@ -978,20 +910,21 @@ void handle_sign_transaction(
     UNUSED(p2);
     UNUSED(tx);
 
-    // Key Index
-    ctx.key_index = U4LE(buffer, 0);
-    
     // Raw Tx
     uint8_t raw_transaction[MAX_TX_SIZE];
     int raw_transaction_length = len - 4;
 
     // Oops Oof Owie
-    if (raw_transaction_length > MAX_TX_SIZE) {
+    if (len < 4 || raw_transaction_length > MAX_TX_SIZE) {
         THROW(EXCEPTION_MALFORMED_APDU);
     }
 
+    // Key Index
+    ctx.key_index = U4LE(buffer, 0);
+
     // copy raw transaction
     memmove(raw_transaction, (buffer + 4), raw_transaction_length);
+    DEBUG_TRACE(TRACE_TX_COPIED);
 
     // Sign Transaction
     hedera_sign(
@@ -1001,21 +934,8 @@ void handle_sign_transaction(
         G_io_apdu_buffer
     );
 
-    // Make in memory buffer into stream
-    pb_istream_t stream = pb_istream_from_buffer(
-        raw_transaction, 
-        raw_transaction_length
-    );
-
-    // Decode the Transaction
-    if (!pb_decode(
-        &stream,
-        HederaTransactionBody_fields, 
-        &ctx.transaction
-    )) {
-        // Oh no couldn't ...
-        THROW(EXCEPTION_MALFORMED_APDU);
-    }
+    decode_transaction(raw_transaction, raw_transaction_length);
+    DEBUG_TRACE(TRACE_TX_DECODED);
 
     handle_transaction_body();
 
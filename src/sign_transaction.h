@@ -1,6 +1,13 @@
 #ifndef LEDGER_APP_HEDERA_SIGN_TRANSACTION_H
 #define LEDGER_APP_HEDERA_SIGN_TRANSACTION_H 1
 
+#include <stdint.h>
+#include <pb.h>
+
+#include "globals.h"
+#include "hedera.h"
+#include "TransactionBody.pb.h"
+
 enum TransactionStep {
     Summary = 1,
     Operator = 2,
@@ -9,15 +16,93 @@ enum TransactionStep {
     Amount = 5,
     Fee = 6,
     Memo =  7,
-    Confirm = 8,
-    Deny = 9
+    ScheduledFee = 8,
+    ScheduledMemo = 9,
+    ScheduleMemo = 10,
+    Confirm = 11,
+    Deny = 12
 };
 
 enum TransactionType {
     Unknown = -1,
     Verify = 0,
     Create = 1,
-    Transfer = 2
+    Transfer = 2,
+    ScheduledCreate = 3,
+    ScheduledTransfer = 4
+};
+
+// What a ScheduleCreate adds to the review of the body it schedules
+struct schedule_t {
+    // which_data of the scheduled body, 0 if the transaction is no schedule
+    pb_size_t data;
+
+    // The scheduled body's own fee and memo
+    uint64_t fee;
+    char memo[pb_membersize(HederaSchedulableTransactionBody, memo)];
+
+    // The memo of the schedule itself
+    char schedule_memo[pb_membersize(HederaScheduleCreateTransactionBody, memo)];
+};
+
+#if defined(TARGET_NANOS)
+// Up to three account IDs and three "<amount> hbar" values; the memos are
+// paged in place from the decoded transaction and its schedule
+#define HBAR_TEXT_SIZE (HBAR_BUF_SIZE + 5)
+#define REVIEW_VALUES_SIZE (3 * ACCOUNT_ID_SIZE + 3 * HBAR_TEXT_SIZE)
+
+// A formatted field of the review, shown DISPLAY_SIZE characters per page
+struct review_field_t {
+    const char* title;
+    const char* text;
+    uint8_t length;
+};
+#elif defined(TARGET_NANOX) || defined(TARGET_NANOS2)
+// Longest single value: the memo, which nanopb bounds to 100 characters
+#define REVIEW_VALUE_SIZE (100 + 1)
+#endif // TARGET
+
+struct sign_tx_context_t {
+    // ui common
+    uint32_t key_index;
+    uint8_t transfer_to_index;
+    uint8_t transfer_from_index;
+
+    // Transaction Summary
+    char summary_line_1[DISPLAY_SIZE + 1];
+    char summary_line_2[DISPLAY_SIZE + 1];
+
+    // type is set based on proto
+    enum TransactionType type;
+
+    struct schedule_t schedule;
+
+#if defined(TARGET_NANOS)
+    char title[DISPLAY_SIZE + 1];
+
+    // Paging needs every shown value at once: they are formatted into
+    // `values` at decode time, and `fields` indexes them by step
+    char values[REVIEW_VALUES_SIZE];
+    uint8_t values_length;
+    struct review_field_t fields[ScheduleMemo - Operator + 1];
+    char partial[DISPLAY_SIZE + 1];
+
+    // Steps correspond to parts of the transaction proto
+    enum TransactionStep step;
+    uint8_t step_index;  // Position of step in review_steps[type]
+
+    uint8_t display_index;  // 1 -> Number Screens
+    uint8_t display_count;  // Number Screens
+
+    uint8_t fast_repeats;  // BUTTON_EVT_FAST events since the button was held
+#elif defined(TARGET_NANOX) || defined(TARGET_NANOS2)
+    // The field on screen, rendered when its flow step is entered
+    char title[DISPLAY_SIZE + 1];
+    char value[REVIEW_VALUE_SIZE];
+#endif // TARGET
+
+    // Parsed transaction
+    HederaTransactionBody transaction;
 };
 
 #if defined(TARGET_NANOS)
@@ -28,48 +113,51 @@ unsigned int ui_tx_summary_step_button(
     unsigned int button_mask_counter
 );
 
-// Step 2 - 7
-void handle_intermediate_left_press();
-void handle_intermediate_right_press();
+// Step 2 - 10
 unsigned int ui_tx_intermediate_step_button(
     unsigned int button_mask,
     unsigned int button_mask_counter
 );
 
-// Step 8
+// Step 11
 unsigned int ui_tx_confirm_step_button(
     unsigned int button_mask,
     unsigned int button_mask_counter
 );
 
-// Step 9
+// Step 12
 unsigned int ui_tx_deny_step_button(
     unsigned int button_mask,
     unsigned int button_mask_counter
 );
 
+// Generic navigation along review_steps
+void goto_step(uint8_t index);
+void review_left_press();
+void review_right_press();
+void review_both_press();
+void review_fast_press(int8_t direction);
+unsigned int review_button(unsigned int button_mask, unsigned int button_mask_counter);
+
 uint8_t num_screens(size_t length);
-void count_screens();
-void shift_display();
 bool first_screen();
 bool last_screen();
+void reformat_title(const char* title);
+void reformat_page();
+void format_fields();
 
 #elif defined(TARGET_NANOX) || defined(TARGET_NANOS2)
 // Forward declarations for Nano X UI
-void x_start_tx_loop();
-void x_continue_tx_loop();
-void x_end_tx_loop();
 unsigned int io_seproxyhal_tx_approve(const bagl_element_t* e);
 unsigned int io_seproxyhal_tx_reject(const bagl_element_t* e);
+void load_field(enum TransactionStep step);
 
 #endif // TARGET
 
-void reformat_operator();
-void reformat_senders();
-void reformat_recipients();
-void reformat_amount();
-void reformat_fee();
-void reformat_memo();
+// Shows the review of the decoded transaction on the current device
+void start_review();
+void decode_transaction(const uint8_t* raw_transaction, size_t length);
+void classify_transaction();
 void handle_transaction_body();
 
 #endif //LEDGER_APP_HEDERA_SIGN_TRANSACTION_H
@@ -0,0 +1,171 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <os.h>
+#include <os_io_seproxyhal.h>
+
+#include "errors.h"
+#include "globals.h"
+#include "handlers.h"
+#include "io.h"
+#include "stats.h"
+
+// INS counted in each slot; slot 0 collects every INS the app does not
+// implement, and every APDU of another CLA whatever its INS
+static const uint8_t slot_ins[] = {
+    0,
+    INS_GET_APP_CONFIGURATION,
+    INS_GET_PUBLIC_KEY,
+    INS_SIGN_TRANSACTION,
+    INS_GET_STATS
+};
+
+#define STATS_SLOTS (sizeof(slot_ins) / sizeof(slot_ins[0]))
+
+// Latency buckets in ticks: 0, 1, 2-3, 4-7, ... and the last one for
+// anything longer
+#define STATS_BUCKETS 8
+
+struct command_stats_t {
+    uint32_t requests;
+    uint32_t ok;
+    uint32_t rejected;
+    uint32_t malformed;
+    uint32_t other;
+    uint16_t latency[STATS_BUCKETS];  // Saturating
+};
+
+static struct command_stats_t stats[STATS_SLOTS];
+static uint32_t ticks;
+
+static uint8_t current_slot;
+static uint32_t current_start;
+static bool current_active;
+
+static uint8_t slot_of(uint8_t ins) {
+    for (uint8_t slot = 1; slot < STATS_SLOTS; slot++) {
+        if (slot_ins[slot] == ins) return slot;
+    }
+
+    return 0;
+}
+
+static uint8_t bucket_of(uint32_t latency) {
+    uint8_t bucket = 0;
+
+    while (latency > 0 && bucket < STATS_BUCKETS - 1) {
+        latency >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+static uint16_t put_u32(uint16_t offset, uint32_t value) {
+    G_io_apdu_buffer[offset++] = value >> 24;
+    G_io_apdu_buffer[offset++] = (value >> 16) & 0xFF;
+    G_io_apdu_buffer[offset++] = (value >> 8) & 0xFF;
+    G_io_apdu_buffer[offset++] = value & 0xFF;
+    return offset;
+}
+
+uint32_t stats_ticks() {
+    return ticks;
+}
+
+// Called from io_event on every SEPROXYHAL ticker event
+void stats_tick() {
+    ticks++;
+}
+
+void stats_begin_command(uint8_t cla, uint8_t ins) {
+    // Only our CLA gives the INS byte a meaning
+    if (cla != CLA) {
+        ins = 0;
+    }
+
+#ifdef HAVE_DEBUG_INS
+    // Not counted: as unimplemented INS they would land in slot 0, and
+    // slots of their own would not fit the response of handle_get_stats
+    if (ins == INS_GET_STACK_USAGE || ins == INS_GET_TRACE) {
+        current_active = false;
+        return;
+    }
+#endif // HAVE_DEBUG_INS
+
+    current_slot = slot_of(ins);
+    current_start = ticks;
+    current_active = true;
+
+    stats[current_slot].requests++;
+}
+
+void stats_end_command(uint16_t sw) {
+    struct command_stats_t* command = &stats[current_slot];
+    uint8_t bucket;
+
+    // Only the first response of a command counts
+    if (!current_active) return;
+    current_active = false;
+
+    switch (sw) {
+        case EXCEPTION_OK:
+            command->ok++;
+            break;
+        case EXCEPTION_USER_REJECTED:
+            command->rejected++;
+            break;
+        case EXCEPTION_MALFORMED_APDU:
+            command->malformed++;
+            break;
+        default:
+            command->other++;
+            break;
+    }
+
+    bucket = bucket_of(ticks - current_start);
+    if (command->latency[bucket] < UINT16_MAX) command->latency[bucket]++;
+}
+
+// Returns the counters kept since boot: one entry for every unimplemented
+// INS and foreign CLA (reported as INS 0), then one per implemented INS, leaving out the
+// debug instructions of DEBUG_INS builds:
+//   { ins (1) | requests (4) | ok (4) | rejected (4) | malformed (4) |
+//     other (4) | latency buckets (8 x 2) }*
+// All values are big-endian. Latency is counted in SEPROXYHAL ticks, from
+// receiving the APDU to sending its status word.
+void handle_get_stats(
+    uint8_t p1,
+    uint8_t p2,
+    uint8_t* buffer,
+    uint16_t len,
+    /* out */ volatile unsigned int* flags,
+    /* out */ volatile unsigned int* tx
+) {
+    UNUSED(p1);
+    UNUSED(p2);
+    UNUSED(buffer);
+    UNUSED(len);
+    UNUSED(flags);
+    UNUSED(tx);
+
+    uint16_t length = 0;
+
+    for (uint8_t slot = 0; slot < STATS_SLOTS; slot++) {
+        const struct command_stats_t* command = &stats[slot];
+
+        G_io_apdu_buffer[length++] = slot_ins[slot];
+        length = put_u32(length, command->requests);
+        length = put_u32(length, command->ok);
+        length = put_u32(length, command->rejected);
+        length = put_u32(length, command->malformed);
+        length = put_u32(length, command->other);
+
+        for (uint8_t bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+            G_io_apdu_buffer[length++] = command->latency[bucket] >> 8;
+            G_io_apdu_buffer[length++] = command->latency[bucket] & 0xFF;
+        }
+    }
+
+    io_exchange_with_code(EXCEPTION_OK, length);
+}
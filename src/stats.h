@@ -0,0 +1,19 @@
+#ifndef LEDGER_HEDERA_STATS_H
+#define LEDGER_HEDERA_STATS_H 1
+
+#include <stdint.h>
+
+// SEPROXYHAL ticker events since boot
+extern uint32_t stats_ticks();
+
+extern void stats_tick();
+
+// A command starts when its APDU is received and ends with the status word
+// of its response, whether sent by io_exchange_with_code or by app_main
+// for an exception. APDUs with another CLA are counted with the
+// unimplemented INS.
+extern void stats_begin_command(uint8_t cla, uint8_t ins);
+
+extern void stats_end_command(uint16_t sw);
+
+#endif // LEDGER_HEDERA_STATS_H